@@ -0,0 +1,417 @@
+// Benchmarks of the client's hot paths against their simple versions.
+//
+// Build and run with:
+//
+//   cc -std=c99 -O2 -pthread wayland-bench.c -o wayland-bench
+//   ./wayland-bench convert
+//   ./wayland-bench shm
+//   ./wayland-bench scale
+//   ./wayland-bench render [threads]
+//
+// The `rle` mode needs the run-length encoded logo (see `wayland-logo-gen`):
+//
+//   cc -std=c99 -O2 -pthread -DWAYLAND_LOGO_RLE wayland-bench.c -o bench-rle
+//   ./bench-rle rle
+//
+// `wayland.c` is compiled in, so that what is measured is exactly what the
+// client runs. Each measurement is the best of a few runs, each run calling
+// the function enough times to take a few tens of milliseconds.
+#define main wayland_main
+#include "wayland.c"
+#undef main
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#if defined(WAYLAND_LOGO_RLE)
+// Not part of the client in this build: only to compare against.
+#include "wayland-logo.h"
+#endif
+
+#if defined(WAYLAND_LOGO_XRGB)
+#error "the conversion kernels are not compiled in with WAYLAND_LOGO_XRGB"
+#endif
+
+typedef struct bench_size_t bench_size_t;
+struct bench_size_t {
+  const char *name;
+  uint32_t w;
+  uint32_t h;
+};
+
+static const bench_size_t bench_sizes[] = {
+    {"logo", 117, 150},    {"720p", 1280, 720}, {"1080p", 1920, 1080},
+    {"1440p", 2560, 1440}, {"4K", 3840, 2160},
+};
+
+static const uint32_t bench_runs = 5;
+// Pixels processed per run, whatever the size.
+static const uint64_t bench_run_pixels = 64 * 1024 * 1024;
+
+static void *bench_alloc(uint64_t size) {
+  void *data = NULL;
+  if (posix_memalign(&data, 64, size) != 0)
+    exit(ENOMEM);
+  // Faulted in now, not while measuring.
+  memset(data, 0, size);
+  return data;
+}
+
+// Average time of one conversion of `pixel_count` pixels, in nanoseconds.
+static double bench_convert(rgb_to_xrgb_fn fn, uint32_t *dst,
+                            const uint8_t *src, uint64_t pixel_count) {
+  uint64_t iterations = bench_run_pixels / pixel_count;
+  if (iterations == 0)
+    iterations = 1;
+
+  double best = 0;
+  for (uint32_t run = 0; run < bench_runs; run++) {
+    uint64_t start = clock_now_ns();
+    for (uint64_t i = 0; i < iterations; i++)
+      fn(dst, src, pixel_count);
+    double ns = (double)(clock_now_ns() - start) / (double)iterations;
+    if (run == 0 || ns < best)
+      best = ns;
+  }
+  return best;
+}
+
+static const char *rgb_to_xrgb_name(rgb_to_xrgb_fn fn) {
+#ifdef WAYLAND_X86_SIMD
+  if (fn == rgb_to_xrgb_avx2)
+    return "avx2";
+  if (fn == rgb_to_xrgb_ssse3)
+    return "ssse3";
+#endif
+  return "scalar";
+}
+
+// `rgb_to_xrgb` as picked at startup, against the scalar loop, from the logo
+// size up to 4K. The source is the logo repeated.
+static void bench_convert_sizes() {
+  rgb_to_xrgb_fn fast = rgb_to_xrgb_select();
+
+  for (uint32_t i = 0; i < array_len(bench_sizes); i++) {
+    const bench_size_t *size = &bench_sizes[i];
+    uint64_t pixel_count = (uint64_t)size->w * size->h;
+
+    uint8_t *src = bench_alloc(pixel_count * 3);
+    for (uint64_t j = 0; j < pixel_count * 3; j += wayland_logo_len) {
+      uint64_t n = pixel_count * 3 - j;
+      if (n > wayland_logo_len)
+        n = wayland_logo_len;
+      memcpy(src + j, wayland_logo, n);
+    }
+    uint32_t *expected = bench_alloc(pixel_count * sizeof(uint32_t));
+    uint32_t *dst = bench_alloc(pixel_count * sizeof(uint32_t));
+
+    double scalar_ns =
+        bench_convert(rgb_to_xrgb_scalar, expected, src, pixel_count);
+    double fast_ns = bench_convert(fast, dst, src, pixel_count);
+    if (memcmp(dst, expected, pixel_count * sizeof(uint32_t)) != 0) {
+      fprintf(stderr, "%s: %s differs from scalar\n", size->name,
+              rgb_to_xrgb_name(fast));
+      exit(1);
+    }
+
+    printf("convert %-5s %4ux%-4u scalar %9.1fus  %-6s %9.1fus  x%.2f\n",
+           size->name, size->w, size->h, scalar_ns / 1000,
+           rgb_to_xrgb_name(fast), fast_ns / 1000, scalar_ns / fast_ns);
+
+    free(src);
+    free(expected);
+    free(dst);
+  }
+}
+
+// Smaller than the logo: scaled down from a smaller mip level.
+static const bench_size_t bench_scale_down_sizes[] = {
+    {"icon", 24, 24},
+    {"small", 48, 64},
+};
+
+typedef void (*scale_frame_fn)(uint32_t *dst, uint32_t w, uint32_t h);
+
+// What `render_logo` does for one frame on one thread: pick the mip level,
+// build the column table, and scale.
+static void scale_frame(uint32_t *dst, uint32_t w, uint32_t h) {
+  const mip_t *mip = logo_mips_pick(w, h);
+  scale_columns_build(w, mip->w);
+  scale_bilinear(dst, w, h, w * color_channels, mip, scale_columns, 0, h);
+}
+
+// The same, one pixel at a time.
+static void scale_frame_scalar(uint32_t *dst, uint32_t w, uint32_t h) {
+  const mip_t *mip = logo_mips_pick(w, h);
+  scale_columns_build(w, mip->w);
+  for (uint32_t y = 0; y < h; y++) {
+    uint32_t y0 = 0, fy = 0;
+    scale_coord(y, h, mip->h, &y0, &fy);
+    const uint32_t *row0 = mip->pixels + y0 * mip->w;
+    scale_row_scalar(dst + y * w, row0, row0 + mip->w, scale_columns, w, fy);
+  }
+}
+
+// Average time of one frame, in nanoseconds.
+static double bench_scale_frame(scale_frame_fn fn, uint32_t *dst,
+                                const bench_size_t *size) {
+  uint64_t iterations = bench_run_pixels / ((uint64_t)size->w * size->h);
+  if (iterations == 0)
+    iterations = 1;
+
+  double best = 0;
+  for (uint32_t run = 0; run < bench_runs; run++) {
+    uint64_t start = clock_now_ns();
+    for (uint64_t i = 0; i < iterations; i++)
+      fn(dst, size->w, size->h);
+    double ns = (double)(clock_now_ns() - start) / (double)iterations;
+    if (run == 0 || ns < best)
+      best = ns;
+  }
+  return best;
+}
+
+static void bench_scale_size(const bench_size_t *size) {
+#if defined(WAYLAND_X86_SIMD) && defined(__SSE2__)
+  const char *fast_name = "sse2";
+#else
+  const char *fast_name = "scalar";
+#endif
+  uint64_t pixel_count = (uint64_t)size->w * size->h;
+  uint32_t *expected = bench_alloc(pixel_count * sizeof(uint32_t));
+  uint32_t *dst = bench_alloc(pixel_count * sizeof(uint32_t));
+
+  double scalar_ns = bench_scale_frame(scale_frame_scalar, expected, size);
+  double fast_ns = bench_scale_frame(scale_frame, dst, size);
+  if (memcmp(dst, expected, pixel_count * sizeof(uint32_t)) != 0) {
+    fprintf(stderr, "%s: %s differs from scalar\n", size->name, fast_name);
+    exit(1);
+  }
+
+  const mip_t *mip = logo_mips_pick(size->w, size->h);
+  printf("scale %-5s %4ux%-4u from %3ux%-3u scalar %9.1fus  %-6s %9.1fus  "
+         "x%.2f\n",
+         size->name, size->w, size->h, mip->w, mip->h, scalar_ns / 1000,
+         fast_name, fast_ns / 1000, scalar_ns / fast_ns);
+
+  free(expected);
+  free(dst);
+}
+
+// `scale_bilinear` against the scalar loop, on one thread, from below the
+// logo size (other mip levels) up to 4K.
+static void bench_scale() {
+  state_t state = {0};
+  logo_mips_build(&state);
+
+  for (uint32_t i = 0; i < array_len(bench_scale_down_sizes); i++)
+    bench_scale_size(&bench_scale_down_sizes[i]);
+  for (uint32_t i = 0; i < array_len(bench_sizes); i++)
+    bench_scale_size(&bench_sizes[i]);
+}
+
+// What `render_logo` does for a large frame: the same, split into tiles on the
+// render pool.
+static void render_frame_pool(uint32_t *dst, uint32_t w, uint32_t h) {
+  state_t state = {0};
+  state.w = w;
+  state.h = h;
+  state.stride = w * color_channels;
+
+  const mip_t *mip = logo_mips_pick(w, h);
+  scale_columns_build(w, mip->w);
+  render_pool_scale(&render_pool, dst, &state, mip);
+}
+
+// The render pool with `threads` threads (main one included) against one
+// thread, for the sizes the client renders on the pool.
+static void bench_render(uint32_t threads) {
+  state_t state = {0};
+  logo_mips_build(&state);
+  render_pool_start(&render_pool, threads - 1);
+
+  for (uint32_t i = 0; i < array_len(bench_sizes); i++) {
+    const bench_size_t *size = &bench_sizes[i];
+    uint64_t pixel_count = (uint64_t)size->w * size->h;
+    if (pixel_count < render_parallel_min_pixels)
+      continue;
+
+    uint32_t *expected = bench_alloc(pixel_count * sizeof(uint32_t));
+    uint32_t *dst = bench_alloc(pixel_count * sizeof(uint32_t));
+
+    double one_ns = bench_scale_frame(scale_frame, expected, size);
+    double pool_ns = bench_scale_frame(render_frame_pool, dst, size);
+    if (memcmp(dst, expected, pixel_count * sizeof(uint32_t)) != 0) {
+      fprintf(stderr, "%s: %u threads differ from 1\n", size->name,
+              render_pool.workers_len + 1);
+      exit(1);
+    }
+
+    printf("render %-5s %4ux%-4u 1 thread %8.1fus  %2u threads %8.1fus  "
+           "x%.2f\n",
+           size->name, size->w, size->h, one_ns / 1000,
+           render_pool.workers_len + 1, pool_ns / 1000, one_ns / pool_ns);
+
+    free(expected);
+    free(dst);
+  }
+}
+
+#if defined(MFD_ALLOW_SEALING)
+typedef int (*shm_file_fn)(uint64_t size);
+
+// Average time to create a pool file, map it and release both, in
+// nanoseconds: what startup pays before touching a page (shmem either way).
+static double bench_shm_file(shm_file_fn fn, uint64_t size) {
+  const uint64_t iterations = 1000;
+
+  double best = 0;
+  for (uint32_t run = 0; run < bench_runs; run++) {
+    uint64_t start = clock_now_ns();
+    for (uint64_t i = 0; i < iterations; i++) {
+      int fd = fn(size);
+      if (fd == -1)
+        exit(errno);
+      void *data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      if (data == MAP_FAILED)
+        exit(errno);
+      munmap(data, size);
+      close(fd);
+    }
+    double ns = (double)(clock_now_ns() - start) / (double)iterations;
+    if (run == 0 || ns < best)
+      best = ns;
+  }
+  return best;
+}
+
+// The sealed memfd against the `shm_open` fallback, for a buffer of each
+// size.
+static void bench_shm() {
+  for (uint32_t i = 0; i < array_len(bench_sizes); i++) {
+    const bench_size_t *size = &bench_sizes[i];
+    uint64_t bytes = (uint64_t)size->w * size->h * color_channels;
+
+    double open_ns = bench_shm_file(shm_file_open, bytes);
+    double memfd_ns = bench_shm_file(shm_file_memfd, bytes);
+    printf("shm %-5s %4ux%-4u shm_open %7.1fus  memfd %7.1fus  x%.2f\n",
+           size->name, size->w, size->h, open_ns / 1000, memfd_ns / 1000,
+           open_ns / memfd_ns);
+  }
+}
+#endif
+
+#if defined(WAYLAND_LOGO_RLE)
+static uint64_t bench_minor_faults() {
+  struct rusage usage = {0};
+  if (getrusage(RUSAGE_SELF, &usage) == -1)
+    exit(errno);
+  return (uint64_t)usage.ru_minflt;
+}
+
+static void rle_decode_logo(uint32_t *dst, const uint8_t *src,
+                            uint64_t pixel_count) {
+  rle_decode_xrgb(dst, pixel_count, src, wayland_logo_rle_len);
+}
+
+// First call, right after startup: the source pages are not mapped yet. Run
+// in a child, where `fork` left them unmapped, so that one measurement does
+// not warm the other up (the kernel maps neighbouring pages of a file on each
+// fault).
+static void bench_cold(const char *name, rgb_to_xrgb_fn fn,
+                       const uint8_t *src, uint64_t src_len) {
+  uint64_t pixel_count = (uint64_t)logo_w * logo_h;
+  uint64_t page_size = (uint64_t)sysconf(_SC_PAGESIZE);
+
+  fflush(stdout);
+  pid_t pid = fork();
+  if (pid == -1)
+    exit(errno);
+  if (pid == 0) {
+    uint32_t *dst = bench_alloc(pixel_count * sizeof(uint32_t));
+
+    uint64_t faults = bench_minor_faults();
+    uint64_t start = clock_now_ns();
+    fn(dst, src, pixel_count);
+    uint64_t cold_ns = clock_now_ns() - start;
+    faults = bench_minor_faults() - faults;
+
+    double warm_ns = bench_convert(fn, dst, src, pixel_count);
+    printf("%-9s %5" PRIu64 " bytes (%2" PRIu64 " pages): cold %5.1fus "
+           "(%" PRIu64 " faults), warm %5.1fus\n",
+           name, src_len, (src_len + page_size - 1) / page_size,
+           (double)cold_ns / 1000, faults, warm_ns / 1000);
+    exit(0);
+  }
+
+  int status = 0;
+  if (waitpid(pid, &status, 0) == -1 || status != 0)
+    exit(1);
+}
+
+// What the RLE logo trades: a decode slower than the raw conversion, against
+// fewer pages of read-only data to fault in on the first frame.
+static void bench_rle() {
+  uint64_t pixel_count = (uint64_t)logo_w * logo_h;
+  uint32_t *expected = bench_alloc(pixel_count * sizeof(uint32_t));
+  uint32_t *dst = bench_alloc(pixel_count * sizeof(uint32_t));
+
+  bench_cold("raw", rgb_to_xrgb, wayland_logo, wayland_logo_len);
+  bench_cold("rle", rle_decode_logo, wayland_logo_rle, wayland_logo_rle_len);
+
+  rgb_to_xrgb(expected, wayland_logo, pixel_count);
+  rle_decode_logo(dst, wayland_logo_rle, pixel_count);
+  if (memcmp(dst, expected, pixel_count * sizeof(uint32_t)) != 0) {
+    fprintf(stderr, "the RLE logo differs from the raw one\n");
+    exit(1);
+  }
+
+  free(expected);
+  free(dst);
+}
+#endif
+
+int main(int argc, char *argv[]) {
+  rgb_to_xrgb = rgb_to_xrgb_select();
+
+  if (argc == 2 && strcmp(argv[1], "convert") == 0) {
+    bench_convert_sizes();
+    return 0;
+  }
+
+  if (argc == 2 && strcmp(argv[1], "scale") == 0) {
+    bench_scale();
+    return 0;
+  }
+
+  if ((argc == 2 || argc == 3) && strcmp(argv[1], "render") == 0) {
+    uint32_t threads = render_workers_default() + 1;
+    if (argc == 3)
+      threads = (uint32_t)strtoul(argv[2], NULL, 10);
+    if (threads == 0 || threads > array_len(render_pool.workers) + 1) {
+      fprintf(stderr, "threads: 1 to %zu\n",
+              array_len(render_pool.workers) + 1);
+      return 1;
+    }
+    bench_render(threads);
+    return 0;
+  }
+
+#if defined(MFD_ALLOW_SEALING)
+  if (argc == 2 && strcmp(argv[1], "shm") == 0) {
+    bench_shm();
+    return 0;
+  }
+#endif
+
+#if defined(WAYLAND_LOGO_RLE)
+  if (argc == 2 && strcmp(argv[1], "rle") == 0) {
+    bench_rle();
+    return 0;
+  }
+#endif
+
+  fprintf(stderr, "Usage: %s convert|scale|render [threads]|shm|rle\n",
+          argv[0]);
+  return 1;
+}
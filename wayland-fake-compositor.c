@@ -0,0 +1,948 @@
+// A headless stand-in for a compositor, to benchmark the client without a
+// display, e.g. on a CI machine. It speaks the subset of the protocol the
+// client uses: the registry globals, `wl_shm`, `xdg_wm_base` pings, configures,
+// frame callbacks, buffer releases, and a seat with a pointer and a keyboard.
+// Pixels are never looked at.
+//
+// Build and run with:
+//
+//   cc -std=c99 -O2 wayland-fake-compositor.c -o wayland-fake-compositor
+//   ./wayland-fake-compositor -f 600 -c 4 -p 2 -m 100 ./wayland
+//
+// It listens on a socket in `$XDG_RUNTIME_DIR`, starts the client with
+// `WAYLAND_DISPLAY` pointing to it, and replays a script:
+//
+// - `-g n`: advertise `n` extra globals, which the client has to skip.
+// - `-s WxH`: the configured size. By default, the client picks its own.
+//   Later configures cycle through a few sizes around it, more than the client
+//   has buffers, so that every frame is fully rendered.
+// - `-c n`: `n` configures after each frame, all but the last one stale.
+// - `-p n`: `n` pings after each frame.
+// - `-m n`: `n` pointer motions after each frame, each in its own pointer
+//   frame.
+// - `-k n`: `n` key presses and releases after each frame.
+// - `-K path`: the XKB keymap to send, e.g. from `xkbcomp :0 keymap.xkb`.
+//   By default, a small US layout.
+// - `-f n`: close the window after `n` frames.
+//
+// Frame callbacks are answered as soon as the surface is committed: there is
+// no vblank to wait for, so the client runs as fast as it can. At the end, the
+// startup latency (from starting the client to its first frame) and the frames
+// per second are printed on stdout. The exit status is the client's.
+#define _POSIX_C_SOURCE 200809L
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <signal.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define array_len(a) (sizeof(a) / sizeof((a)[0]))
+
+#define fds_max 28
+
+static const uint32_t header_size = 8;
+static const uint32_t message_size_max = 4096;
+static const uint32_t display_object_id = 1;
+static const uint32_t shm_format_argb8888 = 0;
+static const uint32_t shm_format_xrgb8888 = 1;
+// Without a frame callback to answer, the client is stuck (e.g. it has nothing
+// to render): give up.
+static const int idle_timeout_ms = 5000;
+static const int32_t configure_step = 16;
+static const uint32_t seat_capabilities = 3; // Pointer and keyboard.
+static const uint32_t keymap_format_xkb_v1 = 1;
+// Linux evdev code, for `KEY_A`.
+static const uint32_t key_a = 30;
+static const uint32_t configure_sizes = 5;
+
+// As `xkbcomp` writes it: what the client parses are the `xkb_keycodes` and
+// `xkb_symbols` sections.
+static const char keymap_default[] =
+    "xkb_keymap {\n"
+    "xkb_keycodes \"evdev+aliases(qwerty)\" {\n"
+    "  minimum = 8;\n"
+    "  maximum = 255;\n"
+    "  <ESC> = 9;\n"
+    "  <AE01> = 10; <AE02> = 11; <AE03> = 12; <AE04> = 13; <AE05> = 14;\n"
+    "  <AE06> = 15; <AE07> = 16; <AE08> = 17; <AE09> = 18; <AE10> = 19;\n"
+    "  <AE11> = 20; <AE12> = 21; <BKSP> = 22; <TAB> = 23;\n"
+    "  <AD01> = 24; <AD02> = 25; <AD03> = 26; <AD04> = 27; <AD05> = 28;\n"
+    "  <AD06> = 29; <AD07> = 30; <AD08> = 31; <AD09> = 32; <AD10> = 33;\n"
+    "  <RTRN> = 36; <LCTL> = 37;\n"
+    "  <AC01> = 38; <AC02> = 39; <AC03> = 40; <AC04> = 41; <AC05> = 42;\n"
+    "  <AC06> = 43; <AC07> = 44; <AC08> = 45; <AC09> = 46;\n"
+    "  <LFSH> = 50;\n"
+    "  <AB01> = 52; <AB02> = 53; <AB03> = 54; <AB04> = 55; <AB05> = 56;\n"
+    "  <AB06> = 57; <AB07> = 58;\n"
+    "  <SPCE> = 65; <FK01> = 67; <UP> = 111; <LEFT> = 113; <RGHT> = 114;\n"
+    "  <DOWN> = 116;\n"
+    "  indicator 1 = \"Caps Lock\";\n"
+    "  alias <LatQ> = <AD01>;\n"
+    "  alias <LatA> = <AC01>;\n"
+    "};\n"
+    "xkb_types \"complete\" {\n"
+    "  virtual_modifiers NumLock;\n"
+    "  type \"ALPHABETIC\" {\n"
+    "    modifiers= Shift+Lock;\n"
+    "    map[Shift]= Level2;\n"
+    "    map[Lock]= Level2;\n"
+    "    level_name[Level1]= \"Base\";\n"
+    "    level_name[Level2]= \"Caps\";\n"
+    "  };\n"
+    "};\n"
+    "xkb_compatibility \"complete\" {\n"
+    "  interpret Shift_L+AnyOf(all) {\n"
+    "    action= SetMods(modifiers=Shift,clearLocks);\n"
+    "  };\n"
+    "};\n"
+    "xkb_symbols \"pc+us+inet(evdev)\" {\n"
+    "  name[group1]=\"English (US)\";\n"
+    "  key <ESC> { [ Escape ] };\n"
+    "  key <AE01> { [ 1, exclam ] };\n"
+    "  key <AE02> { [ 2, at ] };\n"
+    "  key <AE03> { [ 3, numbersign ] };\n"
+    "  key <AE04> { [ 4, dollar ] };\n"
+    "  key <AE05> { [ 5, percent ] };\n"
+    "  key <AE06> { [ 6, asciicircum ] };\n"
+    "  key <AE07> { [ 7, ampersand ] };\n"
+    "  key <AE08> { [ 8, asterisk ] };\n"
+    "  key <AE09> { [ 9, parenleft ] };\n"
+    "  key <AE10> { [ 0, parenright ] };\n"
+    "  key <AE11> { [ minus, underscore ] };\n"
+    "  key <AE12> { [ equal, plus ] };\n"
+    "  key <BKSP> { [ BackSpace, BackSpace ] };\n"
+    "  key <TAB> { [ Tab, ISO_Left_Tab ] };\n"
+    "  key <LatQ> {\n"
+    "    type= \"ALPHABETIC\",\n"
+    "    symbols[Group1]= [ q, Q ]\n"
+    "  };\n"
+    "  key <AD02> { type= \"ALPHABETIC\", symbols[Group1]= [ w, W ] };\n"
+    "  key <AD03> { type= \"ALPHABETIC\", symbols[Group1]= [ e, E ] };\n"
+    "  key <AD04> { type= \"ALPHABETIC\", symbols[Group1]= [ r, R ] };\n"
+    "  key <AD05> { type= \"ALPHABETIC\", symbols[Group1]= [ t, T ] };\n"
+    "  key <AD06> { type= \"ALPHABETIC\", symbols[Group1]= [ y, Y ] };\n"
+    "  key <AD07> { type= \"ALPHABETIC\", symbols[Group1]= [ u, U ] };\n"
+    "  key <AD08> { type= \"ALPHABETIC\", symbols[Group1]= [ i, I ] };\n"
+    "  key <AD09> { type= \"ALPHABETIC\", symbols[Group1]= [ o, O ] };\n"
+    "  key <AD10> { type= \"ALPHABETIC\", symbols[Group1]= [ p, P ] };\n"
+    "  key <RTRN> { [ Return ] };\n"
+    "  key <LCTL> { [ Control_L ] };\n"
+    "  key <LatA> { type= \"ALPHABETIC\", symbols[Group1]= [ a, A ] };\n"
+    "  key <AC02> { type= \"ALPHABETIC\", symbols[Group1]= [ s, S ] };\n"
+    "  key <AC03> { type= \"ALPHABETIC\", symbols[Group1]= [ d, D ] };\n"
+    "  key <AC04> { type= \"ALPHABETIC\", symbols[Group1]= [ f, F ] };\n"
+    "  key <AC05> { type= \"ALPHABETIC\", symbols[Group1]= [ g, G ] };\n"
+    "  key <AC06> { type= \"ALPHABETIC\", symbols[Group1]= [ h, H ] };\n"
+    "  key <AC07> { type= \"ALPHABETIC\", symbols[Group1]= [ j, J ] };\n"
+    "  key <AC08> { type= \"ALPHABETIC\", symbols[Group1]= [ k, K ] };\n"
+    "  key <AC09> { type= \"ALPHABETIC\", symbols[Group1]= [ l, L ] };\n"
+    "  key <LFSH> { [ Shift_L ] };\n"
+    "  key <AB01> { type= \"ALPHABETIC\", symbols[Group1]= [ z, Z ] };\n"
+    "  key <AB02> { type= \"ALPHABETIC\", symbols[Group1]= [ x, X ] };\n"
+    "  key <AB03> { type= \"ALPHABETIC\", symbols[Group1]= [ c, C ] };\n"
+    "  key <AB04> { type= \"ALPHABETIC\", symbols[Group1]= [ v, V ] };\n"
+    "  key <AB05> { type= \"ALPHABETIC\", symbols[Group1]= [ b, B ] };\n"
+    "  key <AB06> { type= \"ALPHABETIC\", symbols[Group1]= [ n, N ] };\n"
+    "  key <AB07> { type= \"ALPHABETIC\", symbols[Group1]= [ m, M ] };\n"
+    "  key <SPCE> { [ space ] };\n"
+    "  key <FK01> { [ F1, F1 ] };\n"
+    "  key <UP> { [ Up ] };\n"
+    "  key <LEFT> { [ Left ] };\n"
+    "  key <RGHT> { [ Right ] };\n"
+    "  key <DOWN> { [ Down ] };\n"
+    "  modifier_map Shift { <LFSH> };\n"
+    "  modifier_map Control { <LCTL> };\n"
+    "};\n"
+    "};\n";
+
+typedef enum interface_t interface_t;
+enum interface_t {
+  INTERFACE_NONE,
+  INTERFACE_WL_DISPLAY,
+  INTERFACE_WL_REGISTRY,
+  INTERFACE_WL_CALLBACK,
+  INTERFACE_WL_COMPOSITOR,
+  INTERFACE_WL_SURFACE,
+  INTERFACE_WL_SHM,
+  INTERFACE_WL_SHM_POOL,
+  INTERFACE_WL_BUFFER,
+  INTERFACE_WL_SEAT,
+  INTERFACE_WL_POINTER,
+  INTERFACE_WL_KEYBOARD,
+  INTERFACE_XDG_WM_BASE,
+  INTERFACE_XDG_SURFACE,
+  INTERFACE_XDG_TOPLEVEL,
+  // Bound, but nothing is done with it.
+  INTERFACE_OTHER,
+};
+
+typedef struct global_t global_t;
+struct global_t {
+  const char *name;
+  uint32_t version;
+  interface_t interface;
+};
+
+// The registry name of a global is its index plus one.
+static const global_t globals[] = {
+    {"wl_compositor", 4, INTERFACE_WL_COMPOSITOR},
+    {"wl_shm", 1, INTERFACE_WL_SHM},
+    {"xdg_wm_base", 1, INTERFACE_XDG_WM_BASE},
+    {"wl_seat", 5, INTERFACE_WL_SEAT},
+    {"wl_output", 2, INTERFACE_OTHER},
+};
+
+typedef struct script_t script_t;
+struct script_t {
+  uint32_t globals_extra;
+  int32_t w, h;
+  uint32_t configures;
+  uint32_t pings;
+  uint32_t motions;
+  uint32_t keys;
+  uint32_t frames;
+  // NULL for `keymap_default`.
+  const char *keymap_path;
+};
+
+typedef struct compositor_t compositor_t;
+struct compositor_t {
+  int fd;
+  script_t script;
+
+  char in[65536] __attribute__((aligned(4)));
+  uint64_t in_len;
+  int fds_in[fds_max];
+  uint32_t fds_in_len;
+  char out[65536] __attribute__((aligned(4)));
+  uint64_t out_len;
+  int fds_out[fds_max];
+  uint32_t fds_out_len;
+
+  uint8_t *objects;
+  uint32_t objects_cap;
+
+  uint32_t xdg_wm_base;
+  uint32_t xdg_surface;
+  uint32_t xdg_toplevel;
+  uint32_t surface;
+  uint32_t pointer;
+  uint32_t keyboard;
+  // Enter events sent.
+  int focused;
+  uint32_t serial;
+  int configured;
+  int closed;
+  // Size of the first buffer, to configure around when the script does not
+  // say.
+  int32_t buffer_w, buffer_h;
+
+  // Pending state, applied on commit.
+  uint32_t pending_buffer;
+  uint32_t pending_callback;
+  // What the client last committed, to release when it is replaced.
+  uint32_t front;
+
+  uint64_t spawn_ns;
+  uint64_t connect_ns;
+  uint64_t first_frame_ns;
+  uint64_t last_frame_ns;
+  uint64_t frames;
+  uint64_t pings_pending;
+  uint64_t pings_sent_ns;
+  uint64_t pongs;
+  uint64_t pong_latency_ns_sum;
+  uint64_t events;
+  uint64_t requests;
+};
+
+static uint64_t clock_now_ns() {
+  struct timespec now = {0};
+  if (clock_gettime(CLOCK_MONOTONIC, &now) == -1)
+    exit(errno);
+  return (uint64_t)now.tv_sec * 1000 * 1000 * 1000 + (uint64_t)now.tv_nsec;
+}
+
+static void protocol_error(const char *what, uint32_t object_id,
+                           uint16_t opcode) {
+  fprintf(stderr, "protocol error: %s (object %u, opcode %u)\n", what,
+          object_id, opcode);
+  exit(EPROTO);
+}
+
+// A new fd for the keymap, which the client maps: a file, or
+// `keymap_default` written to a temporary one (with its terminating NUL, like
+// compositors do).
+static int keymap_open(const char *path, uint32_t *size) {
+  if (path != NULL) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    struct stat st = {0};
+    if (fd == -1 || fstat(fd, &st) == -1) {
+      perror(path);
+      exit(1);
+    }
+    *size = (uint32_t)st.st_size;
+    return fd;
+  }
+
+  FILE *file = tmpfile();
+  if (file == NULL || fwrite(keymap_default, sizeof(keymap_default), 1,
+                             file) != 1 || fflush(file) != 0)
+    exit(errno);
+  int fd = dup(fileno(file));
+  if (fd == -1)
+    exit(errno);
+  fclose(file);
+  *size = sizeof(keymap_default);
+  return fd;
+}
+
+static void compositor_set_object(compositor_t *comp, uint32_t id,
+                                  interface_t interface) {
+  if (id == 0 || id >= 0xff000000)
+    protocol_error("bad new id", id, 0);
+
+  if (id >= comp->objects_cap) {
+    uint32_t cap = comp->objects_cap < 64 ? 64 : comp->objects_cap;
+    while (cap <= id)
+      cap *= 2;
+
+    comp->objects = realloc(comp->objects, cap);
+    assert(comp->objects != NULL);
+    memset(comp->objects + comp->objects_cap, 0, cap - comp->objects_cap);
+    comp->objects_cap = cap;
+  }
+  comp->objects[id] = (uint8_t)interface;
+}
+
+static interface_t compositor_object(const compositor_t *comp, uint32_t id) {
+  return id < comp->objects_cap ? (interface_t)comp->objects[id]
+                                : INTERFACE_NONE;
+}
+
+// The file descriptors go with the first bytes.
+static void compositor_flush(compositor_t *comp) {
+  uint64_t written = 0;
+  while (written < comp->out_len) {
+    char cmsg_buf[CMSG_SPACE(sizeof(int) * fds_max)] = {0};
+    struct iovec iov = {
+        .iov_base = comp->out + written,
+        .iov_len = comp->out_len - written,
+    };
+    struct msghdr msghdr = {.msg_iov = &iov, .msg_iovlen = 1};
+    if (comp->fds_out_len > 0) {
+      msghdr.msg_control = cmsg_buf;
+      msghdr.msg_controllen = CMSG_SPACE(sizeof(int) * comp->fds_out_len);
+      struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msghdr);
+      cmsg->cmsg_level = SOL_SOCKET;
+      cmsg->cmsg_type = SCM_RIGHTS;
+      cmsg->cmsg_len = CMSG_LEN(sizeof(int) * comp->fds_out_len);
+      memcpy(CMSG_DATA(cmsg), comp->fds_out,
+             sizeof(int) * comp->fds_out_len);
+    }
+
+    ssize_t n = sendmsg(comp->fd, &msghdr, MSG_NOSIGNAL);
+    if (n == -1 && errno == EINTR)
+      continue;
+    // The client is gone: its exit status tells why.
+    if (n == -1)
+      break;
+    written += (uint64_t)n;
+
+    for (uint32_t i = 0; i < comp->fds_out_len; i++)
+      close(comp->fds_out[i]);
+    comp->fds_out_len = 0;
+  }
+  comp->out_len = 0;
+
+  if (comp->pings_pending > 0) {
+    comp->pings_sent_ns = clock_now_ns();
+    comp->pings_pending = 0;
+  }
+}
+
+// Queue an event with `words_len` words of arguments, to be filled by the
+// caller.
+static uint32_t *compositor_event(compositor_t *comp, uint32_t object_id,
+                                  uint16_t opcode, uint32_t words_len) {
+  uint32_t size = header_size + words_len * sizeof(uint32_t);
+  assert(size <= message_size_max);
+  if (comp->out_len + size > sizeof(comp->out))
+    compositor_flush(comp);
+
+  uint32_t *msg = (uint32_t *)(comp->out + comp->out_len);
+  msg[0] = object_id;
+  msg[1] = size << 16 | opcode;
+  comp->out_len += size;
+  comp->events++;
+  return msg + 2;
+}
+
+static void compositor_delete_id(compositor_t *comp, uint32_t id) {
+  compositor_event(comp, display_object_id, 1, 1)[0] = id;
+  comp->objects[id] = INTERFACE_NONE;
+}
+
+static void compositor_global(compositor_t *comp, uint32_t registry,
+                              uint32_t name, const char *interface,
+                              uint32_t version) {
+  uint32_t len = (uint32_t)strlen(interface) + 1;
+  uint32_t padded_len = (len + 3) / 4 * 4;
+  uint32_t *args =
+      compositor_event(comp, registry, 0, 3 + padded_len / sizeof(uint32_t));
+  args[0] = name;
+  args[1] = len;
+  memset(args + 2, 0, padded_len);
+  memcpy(args + 2, interface, len);
+  args[2 + padded_len / sizeof(uint32_t)] = version;
+}
+
+static void compositor_configure(compositor_t *comp, int32_t w, int32_t h) {
+  // No states: an empty array.
+  uint32_t *args = compositor_event(comp, comp->xdg_toplevel, 0, 3);
+  args[0] = (uint32_t)w;
+  args[1] = (uint32_t)h;
+  args[2] = 0;
+
+  compositor_event(comp, comp->xdg_surface, 0, 1)[0] = ++comp->serial;
+}
+
+static void compositor_ping(compositor_t *comp) {
+  compositor_event(comp, comp->xdg_wm_base, 0, 1)[0] = ++comp->serial;
+  comp->pings_pending++;
+}
+
+static void compositor_key(compositor_t *comp, uint32_t time_ms,
+                           uint32_t pressed) {
+  uint32_t *args = compositor_event(comp, comp->keyboard, 3, 4);
+  args[0] = ++comp->serial;
+  args[1] = time_ms;
+  args[2] = key_a;
+  args[3] = pressed;
+}
+
+// What happens between two frames, per the script.
+static void compositor_storm(compositor_t *comp) {
+  const script_t *script = &comp->script;
+  int32_t w = script->w != 0 ? script->w : comp->buffer_w;
+  int32_t h = script->h != 0 ? script->h : comp->buffer_h;
+
+  for (uint32_t i = 0; i < script->configures; i++) {
+    // Stale configures get a size out of the cycle.
+    uint32_t size_index = i + 1 == script->configures
+                              ? (uint32_t)(comp->frames % configure_sizes)
+                              : configure_sizes;
+    int32_t step = configure_step * (int32_t)size_index;
+    compositor_configure(comp, w + step, h + step);
+  }
+
+  for (uint32_t i = 0; i < script->pings; i++)
+    compositor_ping(comp);
+
+  // Where a compositor would have 1 event per device report.
+  uint32_t time_ms = (uint32_t)(clock_now_ns() / 1000 / 1000);
+  for (uint32_t i = 0; comp->focused && comp->pointer != 0 &&
+                       i < script->motions;
+       i++) {
+    // 24.8 fixed point.
+    uint32_t *args = compositor_event(comp, comp->pointer, 2, 3);
+    args[0] = time_ms;
+    args[1] = (uint32_t)(i % 64) << 8;
+    args[2] = (uint32_t)(comp->frames % 64) << 8;
+    compositor_event(comp, comp->pointer, 5, 0);
+  }
+
+  for (uint32_t i = 0; comp->focused && comp->keyboard != 0 &&
+                       i < script->keys;
+       i++) {
+    compositor_key(comp, time_ms, 1);
+    compositor_key(comp, time_ms, 0);
+  }
+}
+
+// Once the client has shown something, as a compositor would when the pointer
+// moves over the window and it gets the keyboard focus.
+static void compositor_focus(compositor_t *comp) {
+  if (comp->pointer != 0) {
+    uint32_t *args = compositor_event(comp, comp->pointer, 0, 4);
+    args[0] = ++comp->serial;
+    args[1] = comp->surface;
+    args[2] = 0;
+    args[3] = 0;
+    compositor_event(comp, comp->pointer, 5, 0);
+  }
+
+  if (comp->keyboard != 0) {
+    // No keys pressed: an empty array.
+    uint32_t *args = compositor_event(comp, comp->keyboard, 1, 3);
+    args[0] = ++comp->serial;
+    args[1] = comp->surface;
+    args[2] = 0;
+  }
+  comp->focused = 1;
+}
+
+static void compositor_commit(compositor_t *comp) {
+  if (!comp->configured) {
+    // The initial commit, without a buffer: the client waits for this.
+    compositor_configure(comp, comp->script.w, comp->script.h);
+    for (uint32_t i = 0; i < comp->script.pings; i++)
+      compositor_ping(comp);
+    comp->configured = 1;
+  }
+
+  if (comp->pending_buffer != 0) {
+    uint64_t now_ns = clock_now_ns();
+    if (comp->frames == 0)
+      comp->first_frame_ns = now_ns;
+    comp->last_frame_ns = now_ns;
+    comp->frames++;
+
+    // Done with the previous buffer right away: it would be on screen until
+    // the next vblank on a real compositor.
+    if (comp->front != 0 && comp->front != comp->pending_buffer &&
+        compositor_object(comp, comp->front) == INTERFACE_WL_BUFFER)
+      compositor_event(comp, comp->front, 0, 0);
+    comp->front = comp->pending_buffer;
+    comp->pending_buffer = 0;
+
+    if (!comp->focused)
+      compositor_focus(comp);
+  }
+
+  if (comp->pending_callback != 0) {
+    uint32_t callback = comp->pending_callback;
+    comp->pending_callback = 0;
+    compositor_event(comp, callback, 0, 1)[0] =
+        (uint32_t)(clock_now_ns() / 1000 / 1000);
+    compositor_delete_id(comp, callback);
+
+    if (comp->frames >= comp->script.frames && !comp->closed) {
+      compositor_event(comp, comp->xdg_toplevel, 1, 0);
+      comp->closed = 1;
+    } else if (!comp->closed) {
+      compositor_storm(comp);
+    }
+  }
+}
+
+static uint32_t message_read_u32(const char **args, const char *end,
+                                 uint32_t object_id, uint16_t opcode) {
+  if (end - *args < (ptrdiff_t)sizeof(uint32_t))
+    protocol_error("message too short", object_id, opcode);
+
+  uint32_t res = 0;
+  memcpy(&res, *args, sizeof(res));
+  *args += sizeof(res);
+  return res;
+}
+
+static interface_t message_read_bind(const char **args, const char *end,
+                                     uint32_t object_id) {
+  uint32_t name = message_read_u32(args, end, object_id, 0);
+  uint32_t len = message_read_u32(args, end, object_id, 0);
+  uint32_t padded_len = (len + 3) / 4 * 4;
+  if (len == 0 || end - *args < (ptrdiff_t)padded_len)
+    protocol_error("bad interface string", object_id, 0);
+
+  const char *interface = *args;
+  *args += padded_len;
+
+  if (name == 0 || name > array_len(globals) ||
+      strncmp(globals[name - 1].name, interface, len) != 0)
+    return INTERFACE_OTHER;
+  return globals[name - 1].interface;
+}
+
+static int compositor_pop_fd(compositor_t *comp) {
+  if (comp->fds_in_len == 0)
+    protocol_error("missing fd", 0, 0);
+
+  int fd = comp->fds_in[0];
+  comp->fds_in_len--;
+  memmove(comp->fds_in, comp->fds_in + 1, comp->fds_in_len * sizeof(int));
+  return fd;
+}
+
+static void compositor_handle_request(compositor_t *comp, uint32_t object_id,
+                                      uint16_t opcode, const char *args,
+                                      const char *end) {
+  comp->requests++;
+#define read_u32() message_read_u32(&args, end, object_id, opcode)
+
+  switch (compositor_object(comp, object_id)) {
+  case INTERFACE_WL_DISPLAY:
+    if (opcode == 0) { // sync
+      uint32_t callback = read_u32();
+      compositor_set_object(comp, callback, INTERFACE_WL_CALLBACK);
+      compositor_event(comp, callback, 0, 1)[0] = comp->serial;
+      compositor_delete_id(comp, callback);
+    } else if (opcode == 1) { // get_registry
+      uint32_t registry = read_u32();
+      compositor_set_object(comp, registry, INTERFACE_WL_REGISTRY);
+      for (uint32_t i = 0; i < comp->script.globals_extra; i++) {
+        char name[64] = "";
+        snprintf(name, sizeof(name), "zz_bench_global_with_a_long_name_%u", i);
+        compositor_global(comp, registry, 1000 + i, name, 1);
+      }
+      for (uint32_t i = 0; i < array_len(globals); i++)
+        compositor_global(comp, registry, i + 1, globals[i].name,
+                          globals[i].version);
+    }
+    break;
+  case INTERFACE_WL_REGISTRY:
+    if (opcode == 0) { // bind
+      interface_t interface = message_read_bind(&args, end, object_id);
+      uint32_t version = read_u32();
+      uint32_t id = read_u32();
+      compositor_set_object(comp, id, interface);
+
+      if (interface == INTERFACE_WL_SHM) {
+        compositor_event(comp, id, 0, 1)[0] = shm_format_argb8888;
+        compositor_event(comp, id, 0, 1)[0] = shm_format_xrgb8888;
+      } else if (interface == INTERFACE_XDG_WM_BASE) {
+        comp->xdg_wm_base = id;
+      } else if (interface == INTERFACE_WL_SEAT) {
+        compositor_event(comp, id, 0, 1)[0] = seat_capabilities;
+        if (version >= 2) {
+          // "seat0", NULL terminated and padded.
+          uint32_t *name = compositor_event(comp, id, 1, 3);
+          name[0] = 6;
+          memcpy(name + 1, "seat0\0\0", 8);
+        }
+      }
+    }
+    break;
+  case INTERFACE_WL_COMPOSITOR:
+    if (opcode == 0) { // create_surface
+      comp->surface = read_u32();
+      compositor_set_object(comp, comp->surface, INTERFACE_WL_SURFACE);
+    }
+    break;
+  case INTERFACE_WL_SEAT:
+    if (opcode == 0) { // get_pointer
+      comp->pointer = read_u32();
+      compositor_set_object(comp, comp->pointer, INTERFACE_WL_POINTER);
+    } else if (opcode == 1) { // get_keyboard
+      comp->keyboard = read_u32();
+      compositor_set_object(comp, comp->keyboard, INTERFACE_WL_KEYBOARD);
+
+      uint32_t size = 0;
+      int fd = keymap_open(comp->script.keymap_path, &size);
+      assert(comp->fds_out_len < fds_max);
+      comp->fds_out[comp->fds_out_len++] = fd;
+      uint32_t *args = compositor_event(comp, comp->keyboard, 0, 2);
+      args[0] = keymap_format_xkb_v1;
+      args[1] = size;
+    }
+    break;
+  case INTERFACE_WL_POINTER:
+    if (opcode == 1) { // release
+      comp->pointer = 0;
+      compositor_delete_id(comp, object_id);
+    }
+    break;
+  case INTERFACE_WL_KEYBOARD:
+    if (opcode == 0) { // release
+      comp->keyboard = 0;
+      compositor_delete_id(comp, object_id);
+    }
+    break;
+  case INTERFACE_WL_SURFACE:
+    if (opcode == 1) { // attach
+      comp->pending_buffer = read_u32();
+    } else if (opcode == 3) { // frame
+      comp->pending_callback = read_u32();
+      compositor_set_object(comp, comp->pending_callback,
+                            INTERFACE_WL_CALLBACK);
+    } else if (opcode == 6) { // commit
+      compositor_commit(comp);
+    }
+    break;
+  case INTERFACE_WL_SHM:
+    if (opcode == 0) { // create_pool
+      compositor_set_object(comp, read_u32(), INTERFACE_WL_SHM_POOL);
+      // Pixels are never looked at.
+      close(compositor_pop_fd(comp));
+    }
+    break;
+  case INTERFACE_WL_SHM_POOL:
+    if (opcode == 0) { // create_buffer
+      compositor_set_object(comp, read_u32(), INTERFACE_WL_BUFFER);
+      read_u32(); // Offset.
+      int32_t w = (int32_t)read_u32();
+      int32_t h = (int32_t)read_u32();
+      if (comp->buffer_w == 0) {
+        comp->buffer_w = w;
+        comp->buffer_h = h;
+      }
+    } else if (opcode == 1) { // destroy
+      comp->objects[object_id] = INTERFACE_NONE;
+    }
+    break;
+  case INTERFACE_WL_BUFFER:
+    if (opcode == 0) { // destroy
+      if (comp->front == object_id)
+        comp->front = 0;
+      compositor_delete_id(comp, object_id);
+    }
+    break;
+  case INTERFACE_XDG_WM_BASE:
+    if (opcode == 2) { // get_xdg_surface
+      comp->xdg_surface = read_u32();
+      compositor_set_object(comp, comp->xdg_surface, INTERFACE_XDG_SURFACE);
+    } else if (opcode == 3) { // pong
+      comp->pongs++;
+      comp->pong_latency_ns_sum += clock_now_ns() - comp->pings_sent_ns;
+    }
+    break;
+  case INTERFACE_XDG_SURFACE:
+    if (opcode == 1) { // get_toplevel
+      comp->xdg_toplevel = read_u32();
+      compositor_set_object(comp, comp->xdg_toplevel, INTERFACE_XDG_TOPLEVEL);
+    }
+    break;
+  case INTERFACE_WL_CALLBACK:
+  case INTERFACE_XDG_TOPLEVEL:
+  case INTERFACE_OTHER:
+    break;
+  case INTERFACE_NONE:
+    protocol_error("unknown object", object_id, opcode);
+  }
+#undef read_u32
+}
+
+// Read what is available and handle every complete request. Returns 0 once
+// the client hung up.
+static int compositor_read(compositor_t *comp) {
+  char cmsg_buf[CMSG_SPACE(sizeof(int) * fds_max)] = {0};
+  struct iovec iov = {
+      .iov_base = comp->in + comp->in_len,
+      .iov_len = sizeof(comp->in) - comp->in_len,
+  };
+  struct msghdr msghdr = {
+      .msg_iov = &iov,
+      .msg_iovlen = 1,
+      .msg_control = cmsg_buf,
+      .msg_controllen = sizeof(cmsg_buf),
+  };
+
+  ssize_t n = recvmsg(comp->fd, &msghdr, 0);
+  if (n == -1 && errno == EINTR)
+    return 1;
+  if (n <= 0)
+    return 0;
+  comp->in_len += (uint64_t)n;
+
+  for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msghdr); cmsg != NULL;
+       cmsg = CMSG_NXTHDR(&msghdr, cmsg)) {
+    if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+      continue;
+
+    uint32_t len = (uint32_t)(cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+    if (comp->fds_in_len + len > fds_max)
+      protocol_error("too many fds", 0, 0);
+    memcpy(comp->fds_in + comp->fds_in_len, CMSG_DATA(cmsg),
+           len * sizeof(int));
+    comp->fds_in_len += len;
+  }
+
+  uint64_t offset = 0;
+  while (comp->in_len - offset >= header_size) {
+    uint32_t header[2] = {0};
+    memcpy(header, comp->in + offset, sizeof(header));
+    uint32_t size = header[1] >> 16;
+    uint16_t opcode = header[1] & 0xffff;
+    if (size < header_size || size > message_size_max || size % 4 != 0)
+      protocol_error("bad message size", header[0], opcode);
+    if (comp->in_len - offset < size)
+      break;
+
+    const char *args = comp->in + offset + header_size;
+    compositor_handle_request(comp, header[0], opcode, args,
+                              comp->in + offset + size);
+    offset += size;
+  }
+
+  memmove(comp->in, comp->in + offset, comp->in_len - offset);
+  comp->in_len -= offset;
+  return 1;
+}
+
+static int listen_socket(struct sockaddr_un *addr, const char *display) {
+  const char *xdg_runtime_dir = getenv("XDG_RUNTIME_DIR");
+  if (xdg_runtime_dir == NULL) {
+    fprintf(stderr, "XDG_RUNTIME_DIR is not set\n");
+    exit(EINVAL);
+  }
+
+  int len = snprintf(addr->sun_path, sizeof(addr->sun_path), "%s/%s",
+                     xdg_runtime_dir, display);
+  if (len < 0 || (uint64_t)len >= sizeof(addr->sun_path)) {
+    fprintf(stderr, "socket path too long\n");
+    exit(ENAMETOOLONG);
+  }
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd == -1)
+    exit(errno);
+
+  unlink(addr->sun_path);
+  if (bind(fd, (struct sockaddr *)addr, sizeof(*addr)) == -1)
+    exit(errno);
+  if (listen(fd, 1) == -1)
+    exit(errno);
+
+  return fd;
+}
+
+static void parse_size(const char *s, int32_t *w, int32_t *h) {
+  char *end = NULL;
+  *w = (int32_t)strtol(s, &end, 10);
+  if (*end != 'x' || *w < 0) {
+    fprintf(stderr, "bad size: %s\n", s);
+    exit(EINVAL);
+  }
+  *h = (int32_t)strtol(end + 1, &end, 10);
+  if (*end != 0 || *h < 0) {
+    fprintf(stderr, "bad size: %s\n", s);
+    exit(EINVAL);
+  }
+}
+
+static void compositor_print(const compositor_t *comp) {
+  printf("startup: %.3f ms to connect, %.3f ms to first frame\n",
+         (double)(comp->connect_ns - comp->spawn_ns) / 1000 / 1000,
+         comp->frames > 0
+             ? (double)(comp->first_frame_ns - comp->spawn_ns) / 1000 / 1000
+             : 0.0);
+
+  double seconds = (double)(comp->last_frame_ns - comp->first_frame_ns) / 1e9;
+  printf("frames: %" PRIu64 " in %.3f s, %.1f fps\n", comp->frames, seconds,
+         comp->frames > 1 && seconds > 0 ? (double)(comp->frames - 1) / seconds
+                                         : 0.0);
+  printf("requests: %" PRIu64 ", events: %" PRIu64 "\n", comp->requests,
+         comp->events);
+  if (comp->pongs > 0)
+    printf("ping->pong: %" PRIu64 ", avg %.1fus\n", comp->pongs,
+           (double)comp->pong_latency_ns_sum / comp->pongs / 1000);
+}
+
+int main(int argc, char *argv[]) {
+  compositor_t comp = {.script = {.pings = 1, .configures = 1, .frames = 600}};
+
+  int opt = 0;
+  while ((opt = getopt(argc, argv, "+g:s:c:p:m:k:K:f:")) != -1) {
+    switch (opt) {
+    case 'g':
+      comp.script.globals_extra = (uint32_t)strtoul(optarg, NULL, 10);
+      break;
+    case 's':
+      parse_size(optarg, &comp.script.w, &comp.script.h);
+      break;
+    case 'c':
+      comp.script.configures = (uint32_t)strtoul(optarg, NULL, 10);
+      break;
+    case 'p':
+      comp.script.pings = (uint32_t)strtoul(optarg, NULL, 10);
+      break;
+    case 'm':
+      comp.script.motions = (uint32_t)strtoul(optarg, NULL, 10);
+      break;
+    case 'k':
+      comp.script.keys = (uint32_t)strtoul(optarg, NULL, 10);
+      break;
+    case 'K':
+      comp.script.keymap_path = optarg;
+      break;
+    case 'f':
+      comp.script.frames = (uint32_t)strtoul(optarg, NULL, 10);
+      break;
+    default:
+      fprintf(stderr,
+              "Usage: %s [-g globals] [-s WxH] [-c configures] [-p pings] "
+              "[-m motions] [-k keys] [-K keymap] [-f frames] "
+              "client [args...]\n",
+              argv[0]);
+      return 1;
+    }
+  }
+  if (optind >= argc) {
+    fprintf(stderr, "Missing client command\n");
+    return 1;
+  }
+
+  char display[32] = "";
+  snprintf(display, sizeof(display), "wayland-fake-%d", (int)getpid());
+  struct sockaddr_un addr = {.sun_family = AF_UNIX};
+  int listen_fd = listen_socket(&addr, display);
+
+  comp.spawn_ns = clock_now_ns();
+  pid_t pid = fork();
+  if (pid == -1)
+    exit(errno);
+  if (pid == 0) {
+    if (setenv("WAYLAND_DISPLAY", display, 1) == -1)
+      exit(errno);
+    execvp(argv[optind], argv + optind);
+    perror(argv[optind]);
+    _exit(127);
+  }
+
+  struct pollfd pollfd = {.fd = listen_fd, .events = POLLIN};
+  if (poll(&pollfd, 1, idle_timeout_ms) <= 0) {
+    fprintf(stderr, "the client did not connect\n");
+    kill(pid, SIGTERM);
+  } else {
+    comp.fd = accept(listen_fd, NULL, NULL);
+    if (comp.fd == -1)
+      exit(errno);
+    comp.connect_ns = clock_now_ns();
+    compositor_set_object(&comp, display_object_id, INTERFACE_WL_DISPLAY);
+
+    pollfd.fd = comp.fd;
+    while (1) {
+      compositor_flush(&comp);
+
+      int ready = poll(&pollfd, 1, idle_timeout_ms);
+      if (ready == -1 && errno == EINTR)
+        continue;
+      if (ready == -1)
+        exit(errno);
+      if (ready == 0) {
+        fprintf(stderr, "the client is idle after %" PRIu64 " frames\n",
+                comp.frames);
+        kill(pid, SIGTERM);
+        break;
+      }
+
+      if (!compositor_read(&comp))
+        break;
+    }
+    close(comp.fd);
+    free(comp.objects);
+  }
+  close(listen_fd);
+  unlink(addr.sun_path);
+
+  int status = 0;
+  if (waitpid(pid, &status, 0) == -1)
+    exit(errno);
+
+  compositor_print(&comp);
+  if (WIFEXITED(status))
+    return WEXITSTATUS(status);
+  return 128 + WTERMSIG(status);
+}
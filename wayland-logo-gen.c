@@ -0,0 +1,161 @@
+// Generate derived forms of the Wayland logo from `wayland-logo.h`, so that
+// the client does less work (and embeds less data) at run time.
+//
+// Build and run with:
+//
+//   cc -std=c99 wayland-logo-gen.c -o wayland-logo-gen
+//   tail -c +16 wayland.ppm | ./wayland-logo-gen header > wayland-logo.h
+//   ./wayland-logo-gen xrgb > wayland-logo-xrgb.h
+//   ./wayland-logo-gen rle > wayland-logo-rle.h
+//   ./wayland-logo-gen rgb > wayland-logo.rgb
+//   ./wayland-logo-gen xrgb-raw > wayland-logo.xrgb
+//
+// And compile the client with `-DWAYLAND_LOGO_XRGB`, `-DWAYLAND_LOGO_RLE`, or
+// `-DWAYLAND_LOGO_EMBED`. The `.xrgb` file is instead mapped at run time when
+// `WAYLAND_LOGO_XRGB_PATH` is set.
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "wayland-logo.h"
+
+static uint32_t logo_pixel_xrgb(uint32_t i) {
+  uint8_t r = wayland_logo[i * 3 + 0];
+  uint8_t g = wayland_logo[i * 3 + 1];
+  uint8_t b = wayland_logo[i * 3 + 2];
+  return (r << 16) | (g << 8) | b;
+}
+
+// Same output shape as `xxd -i`, but with 32 bits pixels already in the
+// `wl_shm` XRGB8888 format.
+static void gen_xrgb() {
+  uint32_t pixel_count = wayland_logo_len / 3;
+
+  printf("__attribute__((aligned(64))) const uint32_t wayland_logo_xrgb[] = "
+         "{\n");
+  for (uint32_t i = 0; i < pixel_count; i++) {
+    uint32_t pixel = logo_pixel_xrgb(i);
+
+    printf("%s0x%08x%s", i % 6 == 0 ? "    " : " ", pixel,
+           i + 1 == pixel_count ? "};\n" : (i % 6 == 5 ? ",\n" : ","));
+  }
+  printf("const unsigned int wayland_logo_xrgb_len = %u;\n",
+         pixel_count * (uint32_t)sizeof(uint32_t));
+}
+
+static void print_byte(uint8_t byte, uint32_t i, uint32_t len) {
+  printf("%s0x%02x%s", i % 12 == 0 ? "    " : " ", byte,
+         i + 1 == len ? "};\n" : (i % 12 == 11 ? ",\n" : ","));
+}
+
+static int pixel_eq(const uint8_t *a, const uint8_t *b) {
+  return a[0] == b[0] && a[1] == b[1] && a[2] == b[2];
+}
+
+// Run-length encoding of the RGB pixels, made of packets starting with one
+// byte `n`:
+// - `n & 0x80`: a run, the next RGB pixel repeated `(n & 0x7f) + 1` times.
+// - Otherwise: a literal, the next `n + 1` RGB pixels as-is.
+static void gen_rle() {
+  static uint8_t out[sizeof(wayland_logo) + sizeof(wayland_logo) / 3 + 1];
+  uint32_t out_len = 0;
+  uint32_t pixel_count = wayland_logo_len / 3;
+  const uint32_t packet_max = 128;
+
+  uint32_t i = 0;
+  while (i < pixel_count) {
+    const uint8_t *pixel = &wayland_logo[i * 3];
+
+    uint32_t run = 1;
+    while (i + run < pixel_count && run < packet_max &&
+           pixel_eq(pixel, &wayland_logo[(i + run) * 3]))
+      run++;
+
+    if (run > 1) {
+      out[out_len++] = 0x80 | (run - 1);
+      memcpy(&out[out_len], pixel, 3);
+      out_len += 3;
+      i += run;
+      continue;
+    }
+
+    // Literal: stop right before the next run of at least 2 pixels.
+    uint32_t literal = 1;
+    while (i + literal < pixel_count && literal < packet_max &&
+           !(i + literal + 1 < pixel_count &&
+             pixel_eq(&wayland_logo[(i + literal) * 3],
+                      &wayland_logo[(i + literal + 1) * 3])))
+      literal++;
+
+    out[out_len++] = literal - 1;
+    memcpy(&out[out_len], pixel, literal * 3);
+    out_len += literal * 3;
+    i += literal;
+  }
+
+  printf("const unsigned char wayland_logo_rle[] = {\n");
+  for (uint32_t j = 0; j < out_len; j++)
+    print_byte(out[j], j, out_len);
+  printf("const unsigned int wayland_logo_rle_len = %u;\n", out_len);
+}
+
+// `wayland-logo.h` itself, from the raw RGB pixels on stdin: the output of
+// `xxd -i`, but `const` so that the pixels land in `.rodata`, shared by every
+// client process, and aligned for the conversion kernels' loads.
+static int gen_header() {
+  static uint8_t pixels[16 * 1024 * 1024];
+  uint32_t len = (uint32_t)fread(pixels, 1, sizeof(pixels), stdin);
+  if (ferror(stdin) || !feof(stdin) || len == 0 || len % 3 != 0) {
+    fprintf(stderr, "expected up to %zu bytes of RGB pixels on stdin\n",
+            sizeof(pixels));
+    return 1;
+  }
+
+  printf("// Generated by `wayland-logo-gen header`, do not edit.\n");
+  printf("__attribute__((aligned(64))) const unsigned char wayland_logo[] = "
+         "{\n");
+  for (uint32_t i = 0; i < len; i++)
+    print_byte(pixels[i], i, len);
+  printf("const unsigned int wayland_logo_len = %u;\n", len);
+  return 0;
+}
+
+// The raw RGB pixels, without any C syntax around them, for the client to
+// embed with `#embed` or `.incbin`. Equivalent to
+// `tail -c +16 wayland.ppm > wayland-logo.rgb`.
+static void gen_rgb() { fwrite(wayland_logo, 1, wayland_logo_len, stdout); }
+
+// The XRGB8888 pixels in native byte order, ready to be mapped by the client.
+static void gen_xrgb_raw() {
+  for (uint32_t i = 0; i < wayland_logo_len / 3; i++) {
+    uint32_t pixel = logo_pixel_xrgb(i);
+    fwrite(&pixel, sizeof(pixel), 1, stdout);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  if (argc == 2 && strcmp(argv[1], "header") == 0)
+    return gen_header();
+
+  if (argc == 2 && strcmp(argv[1], "xrgb") == 0) {
+    gen_xrgb();
+    return 0;
+  }
+  if (argc == 2 && strcmp(argv[1], "rle") == 0) {
+    gen_rle();
+    return 0;
+  }
+
+  if (argc == 2 && strcmp(argv[1], "rgb") == 0) {
+    gen_rgb();
+    return 0;
+  }
+
+  if (argc == 2 && strcmp(argv[1], "xrgb-raw") == 0) {
+    gen_xrgb_raw();
+    return 0;
+  }
+
+  fprintf(stderr, "Usage: %s header|xrgb|rle|rgb|xrgb-raw\n", argv[0]);
+  return 1;
+}
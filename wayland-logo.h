@@ -1,4 +1,5 @@
-unsigned char wayland_logo[] = {
+// Generated by `wayland-logo-gen header`, do not edit.
+__attribute__((aligned(64))) const unsigned char wayland_logo[] = {
     0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
     0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
     0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
@@ -4387,4 +4388,4 @@ unsigned char wayland_logo[] = {
     0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
     0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
     0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
-unsigned int wayland_logo_len = 52650;
+const unsigned int wayland_logo_len = 52650;
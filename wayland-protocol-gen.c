@@ -0,0 +1,651 @@
+// Generate fixed-layout encoders and decoders from Wayland protocol XML files,
+// e.g. `wayland.xml` and `xdg-shell.xml`.
+//
+// Build and run with:
+//
+//   cc -std=c99 wayland-protocol-gen.c -o wayland-protocol-gen
+//   ./wayland-protocol-gen wayland.xml xdg-shell.xml > wayland-protocol.h
+//
+// The XML files are copies of the ones shipping with `wayland` and
+// `wayland-protocols`, and the output is checked in: re-run after updating
+// them.
+//
+// Every name is `wayland_<interface>_<message>_<what>`, for requests and events
+// alike. For each request, the header has its opcode, its size (a constant when
+// the message has no string nor array), and an encoder writing the message
+// straight into 32 bits words. For each event, its opcode, a struct with its
+// arguments and a decoder filling it (strings and arrays point into the
+// message, nothing is copied), or returning 0 when the message does not match
+// the signature. For each interface, the count of file descriptors each of its
+// events carries. Constants are enums, so that the (many) unused ones do not
+// trigger warnings.
+//
+// Only the subset of XML the protocol files use is understood.
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define cstring_len(s) (sizeof(s) - 1)
+
+#define array_len(a) (sizeof(a) / sizeof((a)[0]))
+
+typedef enum arg_type_t arg_type_t;
+enum arg_type_t {
+  ARG_INT,
+  ARG_UINT,
+  ARG_FIXED,
+  ARG_OBJECT,
+  ARG_NEW_ID,
+  // `new_id` without an interface (only `wl_registry.bind`): on the wire, the
+  // interface name and version precede the id.
+  ARG_NEW_ID_DYNAMIC,
+  ARG_STRING,
+  ARG_ARRAY,
+  // Sent as ancillary data, not part of the message.
+  ARG_FD,
+};
+
+typedef struct arg_t arg_t;
+struct arg_t {
+  char name[64];
+  arg_type_t type;
+  // Strings only: a length of 0 stands for NULL.
+  int allow_null;
+};
+
+typedef struct message_t message_t;
+struct message_t {
+  char name[64];
+  arg_t args[32];
+  uint32_t args_len;
+};
+
+typedef struct interface_t interface_t;
+struct interface_t {
+  char name[64];
+  message_t requests[64];
+  uint32_t requests_len;
+  message_t events[64];
+  uint32_t events_len;
+};
+
+typedef struct tag_t tag_t;
+struct tag_t {
+  char name[32];
+  char attr_name[64];
+  char attr_type[32];
+  char attr_interface[64];
+  int attr_allow_null;
+  int closing;
+  int self_closing;
+};
+
+static char *read_file(const char *path) {
+  FILE *file = fopen(path, "rb");
+  if (file == NULL) {
+    perror(path);
+    exit(1);
+  }
+
+  long size = -1;
+  if (fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) < 0 ||
+      fseek(file, 0, SEEK_SET) != 0) {
+    perror(path);
+    exit(1);
+  }
+
+  char *data = malloc((size_t)size + 1);
+  if (data == NULL) {
+    perror("malloc");
+    exit(1);
+  }
+  if (fread(data, 1, (size_t)size, file) != (size_t)size) {
+    perror(path);
+    exit(1);
+  }
+  data[size] = 0;
+  fclose(file);
+
+  return data;
+}
+
+static void copy_attr(char *dst, uint64_t dst_cap, const char *src,
+                      uint64_t src_len) {
+  if (src_len >= dst_cap) {
+    fprintf(stderr, "name too long (max %lu bytes): %.*s\n",
+            (unsigned long)dst_cap - 1, (int)src_len, src);
+    exit(1);
+  }
+  memcpy(dst, src, src_len);
+  dst[src_len] = 0;
+}
+
+// Parse the tag starting at `*cursor` (on `<`) and move past it. Comments,
+// processing instructions and text are skipped by the caller.
+static void parse_tag(char **cursor, tag_t *tag) {
+  memset(tag, 0, sizeof(*tag));
+
+  char *c = *cursor + 1;
+  if (*c == '/') {
+    tag->closing = 1;
+    c++;
+  }
+
+  char *name = c;
+  while (*c && *c != ' ' && *c != '\n' && *c != '\t' && *c != '>' &&
+         *c != '/')
+    c++;
+  copy_attr(tag->name, sizeof(tag->name), name, (uint64_t)(c - name));
+
+  while (*c && *c != '>') {
+    if (*c == '/') {
+      tag->self_closing = 1;
+      c++;
+      continue;
+    }
+    if (*c == ' ' || *c == '\n' || *c == '\t') {
+      c++;
+      continue;
+    }
+
+    char *key = c;
+    while (*c && *c != '=')
+      c++;
+    uint64_t key_len = (uint64_t)(c - key);
+    if (c[0] != '=' || c[1] != '"') {
+      fprintf(stderr, "malformed attribute: %.*s\n", (int)key_len, key);
+      exit(1);
+    }
+    c += 2;
+
+    char *value = c;
+    while (*c && *c != '"')
+      c++;
+    uint64_t value_len = (uint64_t)(c - value);
+    if (*c != '"') {
+      fprintf(stderr, "unterminated attribute value: %.*s\n", (int)key_len,
+              key);
+      exit(1);
+    }
+    c++;
+
+    if (key_len == cstring_len("name") && memcmp(key, "name", key_len) == 0)
+      copy_attr(tag->attr_name, sizeof(tag->attr_name), value, value_len);
+    else if (key_len == cstring_len("type") &&
+             memcmp(key, "type", key_len) == 0)
+      copy_attr(tag->attr_type, sizeof(tag->attr_type), value, value_len);
+    else if (key_len == cstring_len("interface") &&
+             memcmp(key, "interface", key_len) == 0)
+      copy_attr(tag->attr_interface, sizeof(tag->attr_interface), value,
+                value_len);
+    else if (key_len == cstring_len("allow-null") &&
+             memcmp(key, "allow-null", key_len) == 0)
+      tag->attr_allow_null = value_len == cstring_len("true") &&
+                             memcmp(value, "true", value_len) == 0;
+  }
+  if (*c != '>') {
+    fprintf(stderr, "unterminated tag: %s\n", tag->name);
+    exit(1);
+  }
+  *cursor = c + 1;
+}
+
+static arg_type_t parse_arg_type(const tag_t *tag) {
+  const char *type = tag->attr_type;
+  if (strcmp(type, "int") == 0)
+    return ARG_INT;
+  if (strcmp(type, "uint") == 0)
+    return ARG_UINT;
+  if (strcmp(type, "fixed") == 0)
+    return ARG_FIXED;
+  if (strcmp(type, "object") == 0)
+    return ARG_OBJECT;
+  if (strcmp(type, "new_id") == 0)
+    return tag->attr_interface[0] ? ARG_NEW_ID : ARG_NEW_ID_DYNAMIC;
+  if (strcmp(type, "string") == 0)
+    return ARG_STRING;
+  if (strcmp(type, "array") == 0)
+    return ARG_ARRAY;
+  if (strcmp(type, "fd") == 0)
+    return ARG_FD;
+
+  fprintf(stderr, "unknown argument type: %s\n", type);
+  exit(1);
+}
+
+static uint32_t parse_protocol(char *xml, interface_t *interfaces,
+                               uint32_t interfaces_cap) {
+  uint32_t interfaces_len = 0;
+  interface_t *interface = NULL;
+  message_t *message = NULL;
+
+  char *c = xml;
+  while ((c = strchr(c, '<')) != NULL) {
+    if (strncmp(c, "<!--", 4) == 0) {
+      c = strstr(c, "-->");
+      if (c == NULL) {
+        fprintf(stderr, "unterminated comment\n");
+        exit(1);
+      }
+      continue;
+    }
+    if (c[1] == '?' || c[1] == '!') {
+      c = strchr(c, '>');
+      if (c == NULL) {
+        fprintf(stderr, "unterminated declaration\n");
+        exit(1);
+      }
+      continue;
+    }
+
+    tag_t tag = {0};
+    parse_tag(&c, &tag);
+
+    if (strcmp(tag.name, "interface") == 0 && !tag.closing) {
+      if (interfaces_len == interfaces_cap) {
+        fprintf(stderr, "too many interfaces (max %u): %s\n", interfaces_cap,
+                tag.attr_name);
+        exit(1);
+      }
+      interface = &interfaces[interfaces_len++];
+      memset(interface, 0, sizeof(*interface));
+      memcpy(interface->name, tag.attr_name, sizeof(interface->name));
+    } else if (strcmp(tag.name, "interface") == 0) {
+      interface = NULL;
+    } else if ((strcmp(tag.name, "request") == 0 ||
+                strcmp(tag.name, "event") == 0) &&
+               !tag.closing) {
+      if (interface == NULL) {
+        fprintf(stderr, "%s outside of an interface: %s\n", tag.name,
+                tag.attr_name);
+        exit(1);
+      }
+      int is_request = strcmp(tag.name, "request") == 0;
+      uint32_t *len =
+          is_request ? &interface->requests_len : &interface->events_len;
+      message_t *messages =
+          is_request ? interface->requests : interface->events;
+      uint32_t cap = is_request ? array_len(interface->requests)
+                                : array_len(interface->events);
+      if (*len == cap) {
+        fprintf(stderr, "too many %ss in %s (max %u): %s\n", tag.name,
+                interface->name, cap, tag.attr_name);
+        exit(1);
+      }
+
+      message = &messages[(*len)++];
+      memset(message, 0, sizeof(*message));
+      memcpy(message->name, tag.attr_name, sizeof(message->name));
+      if (tag.self_closing)
+        message = NULL;
+    } else if (strcmp(tag.name, "request") == 0 ||
+               strcmp(tag.name, "event") == 0) {
+      message = NULL;
+    } else if (strcmp(tag.name, "arg") == 0 && !tag.closing) {
+      if (message == NULL) {
+        fprintf(stderr, "arg outside of a request or event: %s\n",
+                tag.attr_name);
+        exit(1);
+      }
+      if (message->args_len == array_len(message->args)) {
+        fprintf(stderr, "too many args in %s (max %u): %s\n", message->name,
+                (uint32_t)array_len(message->args), tag.attr_name);
+        exit(1);
+      }
+
+      arg_t *arg = &message->args[message->args_len++];
+      memcpy(arg->name, tag.attr_name, sizeof(arg->name));
+      arg->type = parse_arg_type(&tag);
+      arg->allow_null = tag.attr_allow_null;
+    }
+  }
+
+  return interfaces_len;
+}
+
+static int arg_is_variable(arg_type_t type) {
+  return type == ARG_STRING || type == ARG_ARRAY ||
+         type == ARG_NEW_ID_DYNAMIC;
+}
+
+// Size of the fixed part, header included.
+static uint32_t message_fixed_size(const message_t *message) {
+  uint32_t size = 8;
+  for (uint32_t i = 0; i < message->args_len; i++) {
+    switch (message->args[i].type) {
+    case ARG_FD:
+      break;
+    case ARG_STRING:
+    case ARG_ARRAY:
+      size += 4; // Length.
+      break;
+    case ARG_NEW_ID_DYNAMIC:
+      size += 4 * 3; // Interface length, version, id.
+      break;
+    default:
+      size += 4;
+    }
+  }
+  return size;
+}
+
+static int message_is_variable(const message_t *message) {
+  for (uint32_t i = 0; i < message->args_len; i++) {
+    if (arg_is_variable(message->args[i].type))
+      return 1;
+  }
+  return 0;
+}
+
+// Arguments are prefixed with `arg_` to stay clear of C keywords and of our
+// own locals. Requests only.
+static void print_params(const message_t *message) {
+  for (uint32_t i = 0; i < message->args_len; i++) {
+    const arg_t *arg = &message->args[i];
+    switch (arg->type) {
+    case ARG_INT:
+    case ARG_FIXED:
+      printf(", int32_t arg_%s", arg->name);
+      break;
+    case ARG_UINT:
+    case ARG_OBJECT:
+    case ARG_NEW_ID:
+      printf(", uint32_t arg_%s", arg->name);
+      break;
+    case ARG_NEW_ID_DYNAMIC:
+      printf(", const char *arg_interface, uint32_t arg_interface_len"
+             ", uint32_t arg_version, uint32_t arg_%s",
+             arg->name);
+      break;
+    case ARG_STRING:
+      // The length includes the NULL terminator.
+      printf(", const char *arg_%s, uint32_t arg_%s_len", arg->name,
+             arg->name);
+      break;
+    case ARG_ARRAY:
+      printf(", const void *arg_%s, uint32_t arg_%s_len", arg->name, arg->name);
+      break;
+    case ARG_FD:
+      // Sent as ancillary data, by the caller.
+      break;
+    }
+  }
+}
+
+static void print_size_params(const message_t *message) {
+  int first = 1;
+  for (uint32_t i = 0; i < message->args_len; i++) {
+    const arg_t *arg = &message->args[i];
+    if (arg->type == ARG_STRING || arg->type == ARG_ARRAY) {
+      printf("%suint32_t arg_%s_len", first ? "" : ", ", arg->name);
+      first = 0;
+    } else if (arg->type == ARG_NEW_ID_DYNAMIC) {
+      printf("%suint32_t arg_interface_len", first ? "" : ", ");
+      first = 0;
+    }
+  }
+}
+
+static void print_request(const interface_t *interface, uint32_t opcode) {
+  const message_t *message = &interface->requests[opcode];
+  const char *i = interface->name;
+  const char *m = message->name;
+
+  printf("\n// %s.%s\n", i, m);
+  printf("enum { wayland_%s_%s_opcode = %u };\n", i, m, opcode);
+
+  int variable = message_is_variable(message);
+  if (variable) {
+    printf("static inline uint16_t wayland_%s_%s_size(", i, m);
+    print_size_params(message);
+    printf(") {\n  return %u", message_fixed_size(message));
+    for (uint32_t a = 0; a < message->args_len; a++) {
+      const arg_t *arg = &message->args[a];
+      if (arg->type == ARG_STRING || arg->type == ARG_ARRAY)
+        printf(" + ((arg_%s_len + 3) & -4)", arg->name);
+      else if (arg->type == ARG_NEW_ID_DYNAMIC)
+        printf(" + ((arg_interface_len + 3) & -4)");
+    }
+    printf(";\n}\n");
+  } else {
+    printf("enum { wayland_%s_%s_size = %u };\n", i, m,
+           message_fixed_size(message));
+  }
+
+  printf("static inline void wayland_%s_%s_encode(uint32_t *msg, "
+         "uint32_t self",
+         i, m);
+  print_params(message);
+  printf(") {\n");
+  printf("  msg[0] = self;\n");
+  if (variable) {
+    printf("  uint16_t size = wayland_%s_%s_size(", i, m);
+    int first = 1;
+    for (uint32_t a = 0; a < message->args_len; a++) {
+      const arg_t *arg = &message->args[a];
+      if (arg->type == ARG_STRING || arg->type == ARG_ARRAY) {
+        printf("%sarg_%s_len", first ? "" : ", ", arg->name);
+        first = 0;
+      } else if (arg->type == ARG_NEW_ID_DYNAMIC) {
+        printf("%sarg_interface_len", first ? "" : ", ");
+        first = 0;
+      }
+    }
+    printf(");\n");
+    printf("  msg[1] = (uint32_t)size << 16 | wayland_%s_%s_opcode;\n", i, m);
+    printf("  uint32_t *w = msg + 2;\n");
+  } else {
+    printf("  msg[1] = (uint32_t)wayland_%s_%s_size << 16 | "
+           "wayland_%s_%s_opcode;\n",
+           i, m, i, m);
+  }
+
+  // Fixed messages use constant indices; variable ones a moving cursor.
+  uint32_t word = 2;
+  for (uint32_t a = 0; a < message->args_len; a++) {
+    const arg_t *arg = &message->args[a];
+    switch (arg->type) {
+    case ARG_FD:
+      printf("  // `%s`: sent as ancillary data.\n", arg->name);
+      break;
+    case ARG_STRING:
+    case ARG_ARRAY:
+    case ARG_NEW_ID_DYNAMIC: {
+      const char *name =
+          arg->type == ARG_NEW_ID_DYNAMIC ? "interface" : arg->name;
+      printf("  *w++ = arg_%s_len;\n", name);
+      printf("  memcpy(w, arg_%s, arg_%s_len);\n", name, name);
+      printf("  memset((char *)w + arg_%s_len, 0, ((arg_%s_len + 3) & -4) - "
+             "arg_%s_len);\n",
+             name, name, name);
+      printf("  w += (arg_%s_len + 3) / 4;\n", name);
+      if (arg->type == ARG_NEW_ID_DYNAMIC) {
+        printf("  *w++ = arg_version;\n");
+        printf("  *w++ = arg_%s;\n", arg->name);
+      }
+      break;
+    }
+    default:
+      if (variable)
+        printf("  *w++ = (uint32_t)arg_%s;\n", arg->name);
+      else
+        printf("  msg[%u] = (uint32_t)arg_%s;\n", word++, arg->name);
+    }
+  }
+  if (variable)
+    printf("  (void)w;\n");
+  printf("}\n");
+}
+
+static void print_event(const interface_t *interface, uint32_t opcode) {
+  const message_t *message = &interface->events[opcode];
+  const char *i = interface->name;
+  const char *m = message->name;
+
+  printf("\n// %s.%s\n", i, m);
+  printf("enum { wayland_%s_%s_opcode = %u };\n", i, m, opcode);
+  if (message_fixed_size(message) == 8)
+    return;
+
+  printf("typedef struct wayland_%s_%s_event_t wayland_%s_%s_event_t;\n", i, m,
+         i, m);
+  printf("struct wayland_%s_%s_event_t {\n", i, m);
+  for (uint32_t a = 0; a < message->args_len; a++) {
+    const arg_t *arg = &message->args[a];
+    switch (arg->type) {
+    case ARG_INT:
+    case ARG_FIXED:
+      printf("  int32_t %s;\n", arg->name);
+      break;
+    case ARG_STRING:
+      printf("  const char *%s;\n  uint32_t %s_len;\n", arg->name, arg->name);
+      break;
+    case ARG_ARRAY:
+      printf("  const void *%s;\n  uint32_t %s_len;\n", arg->name, arg->name);
+      break;
+    case ARG_FD:
+      printf("  // `%s`: received as ancillary data.\n", arg->name);
+      break;
+    default:
+      printf("  uint32_t %s;\n", arg->name);
+    }
+  }
+  printf("};\n");
+
+  // `body` is right after the header, `body_len` bytes long. Returns 0 when
+  // it is not exactly one such event: the caller decides what to do with a
+  // broken compositor.
+  uint32_t fixed_len = message_fixed_size(message) - 8;
+  int variable = message_is_variable(message);
+  printf("static inline int wayland_%s_%s_decode(const uint32_t *body, "
+         "uint64_t body_len, wayland_%s_%s_event_t *event) {\n",
+         i, m, i, m);
+  if (variable) {
+    printf("  if (body_len %% 4 != 0 || body_len < %u)\n    return 0;\n",
+           fixed_len);
+    printf("  const uint32_t *end = body + body_len / 4;\n");
+  } else {
+    printf("  if (body_len != %u)\n    return 0;\n", fixed_len);
+  }
+  printf("  const uint32_t *r = body;\n");
+
+  // Past a string or an array, each word is checked before being read.
+  int checked = 1;
+  for (uint32_t a = 0; a < message->args_len; a++) {
+    const arg_t *arg = &message->args[a];
+    if (arg->type == ARG_FD)
+      continue;
+    if (!checked)
+      printf("  if (r == end)\n    return 0;\n");
+
+    switch (arg->type) {
+    case ARG_INT:
+    case ARG_FIXED:
+      printf("  event->%s = (int32_t)*r++;\n", arg->name);
+      break;
+    case ARG_STRING:
+    case ARG_ARRAY:
+      printf("  event->%s_len = *r++;\n", arg->name);
+      printf("  if ((uint64_t)(end - r) * 4 < event->%s_len)\n"
+             "    return 0;\n",
+             arg->name);
+      printf("  event->%s = (const void *)r;\n", arg->name);
+      // The length includes the NULL terminator.
+      if (arg->type == ARG_STRING && arg->allow_null)
+        printf("  if (event->%s_len == 0)\n    event->%s = NULL;\n"
+               "  else if (event->%s[event->%s_len - 1] != 0)\n"
+               "    return 0;\n",
+               arg->name, arg->name, arg->name, arg->name);
+      else if (arg->type == ARG_STRING)
+        printf("  if (event->%s_len == 0 || "
+               "event->%s[event->%s_len - 1] != 0)\n    return 0;\n",
+               arg->name, arg->name, arg->name);
+      printf("  r += (event->%s_len + 3) / 4;\n", arg->name);
+      checked = 0;
+      break;
+    default:
+      printf("  event->%s = *r++;\n", arg->name);
+    }
+  }
+  if (variable)
+    printf("  return r == end;\n");
+  else
+    printf("  (void)r;\n  return 1;\n");
+  printf("}\n");
+}
+
+// File descriptors each event carries, by opcode: for the caller to take them
+// off the connection even for events it skips. A function rather than a table,
+// so that it costs nothing when unused.
+static void print_event_fds(const interface_t *interface) {
+  const char *i = interface->name;
+
+  printf("\n// %s events: file descriptors received along.\n", i);
+  printf("static inline uint32_t wayland_%s_event_fds(uint16_t opcode) {\n",
+         i);
+  int any = 0;
+  for (uint32_t e = 0; e < interface->events_len; e++) {
+    const message_t *message = &interface->events[e];
+    uint32_t fds = 0;
+    for (uint32_t a = 0; a < message->args_len; a++)
+      fds += message->args[a].type == ARG_FD;
+    if (fds == 0)
+      continue;
+
+    if (!any)
+      printf("  switch (opcode) {\n");
+    any = 1;
+    printf("  case wayland_%s_%s_opcode:\n    return %u;\n", i, message->name,
+           fds);
+  }
+  if (any)
+    printf("  default:\n    return 0;\n  }\n}\n");
+  else
+    printf("  (void)opcode;\n  return 0;\n}\n");
+}
+
+// Requests and events share the naming scheme: a request and an event with the
+// same name would define the same symbols.
+static void check_names(const interface_t *interface) {
+  for (uint32_t r = 0; r < interface->requests_len; r++) {
+    for (uint32_t e = 0; e < interface->events_len; e++) {
+      if (strcmp(interface->requests[r].name, interface->events[e].name) == 0) {
+        fprintf(stderr, "%s.%s: both a request and an event\n",
+                interface->name, interface->requests[r].name);
+        exit(1);
+      }
+    }
+  }
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s protocol.xml...\n", argv[0]);
+    return 1;
+  }
+
+  static interface_t interfaces[256];
+  uint32_t interfaces_len = 0;
+  for (int i = 1; i < argc; i++) {
+    interfaces_len += parse_protocol(read_file(argv[i]),
+                                     interfaces + interfaces_len,
+                                     array_len(interfaces) - interfaces_len);
+  }
+
+  printf("// Generated by `wayland-protocol-gen`, do not edit.\n");
+  printf("#include <assert.h>\n#include <stdint.h>\n#include <string.h>\n");
+
+  for (uint32_t i = 0; i < interfaces_len; i++) {
+    const interface_t *interface = &interfaces[i];
+    check_names(interface);
+    for (uint32_t r = 0; r < interface->requests_len; r++)
+      print_request(interface, r);
+    for (uint32_t e = 0; e < interface->events_len; e++)
+      print_event(interface, e);
+    if (interface->events_len > 0)
+      print_event_fds(interface);
+  }
+
+  return 0;
+}
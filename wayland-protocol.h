@@ -0,0 +1,2278 @@
+// Generated by `wayland-protocol-gen`, do not edit.
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+// wl_display.sync
+enum { wayland_wl_display_sync_opcode = 0 };
+enum { wayland_wl_display_sync_size = 12 };
+static inline void wayland_wl_display_sync_encode(uint32_t *msg, uint32_t self, uint32_t arg_callback) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_display_sync_size << 16 | wayland_wl_display_sync_opcode;
+  msg[2] = (uint32_t)arg_callback;
+}
+
+// wl_display.get_registry
+enum { wayland_wl_display_get_registry_opcode = 1 };
+enum { wayland_wl_display_get_registry_size = 12 };
+static inline void wayland_wl_display_get_registry_encode(uint32_t *msg, uint32_t self, uint32_t arg_registry) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_display_get_registry_size << 16 | wayland_wl_display_get_registry_opcode;
+  msg[2] = (uint32_t)arg_registry;
+}
+
+// wl_display.error
+enum { wayland_wl_display_error_opcode = 0 };
+typedef struct wayland_wl_display_error_event_t wayland_wl_display_error_event_t;
+struct wayland_wl_display_error_event_t {
+  uint32_t object_id;
+  uint32_t code;
+  const char *message;
+  uint32_t message_len;
+};
+static inline int wayland_wl_display_error_decode(const uint32_t *body, uint64_t body_len, wayland_wl_display_error_event_t *event) {
+  if (body_len % 4 != 0 || body_len < 12)
+    return 0;
+  const uint32_t *end = body + body_len / 4;
+  const uint32_t *r = body;
+  event->object_id = *r++;
+  event->code = *r++;
+  event->message_len = *r++;
+  if ((uint64_t)(end - r) * 4 < event->message_len)
+    return 0;
+  event->message = (const void *)r;
+  if (event->message_len == 0 || event->message[event->message_len - 1] != 0)
+    return 0;
+  r += (event->message_len + 3) / 4;
+  return r == end;
+}
+
+// wl_display.delete_id
+enum { wayland_wl_display_delete_id_opcode = 1 };
+typedef struct wayland_wl_display_delete_id_event_t wayland_wl_display_delete_id_event_t;
+struct wayland_wl_display_delete_id_event_t {
+  uint32_t id;
+};
+static inline int wayland_wl_display_delete_id_decode(const uint32_t *body, uint64_t body_len, wayland_wl_display_delete_id_event_t *event) {
+  if (body_len != 4)
+    return 0;
+  const uint32_t *r = body;
+  event->id = *r++;
+  (void)r;
+  return 1;
+}
+
+// wl_display events: file descriptors received along.
+static inline uint32_t wayland_wl_display_event_fds(uint16_t opcode) {
+  (void)opcode;
+  return 0;
+}
+
+// wl_registry.bind
+enum { wayland_wl_registry_bind_opcode = 0 };
+static inline uint16_t wayland_wl_registry_bind_size(uint32_t arg_interface_len) {
+  return 24 + ((arg_interface_len + 3) & -4);
+}
+static inline void wayland_wl_registry_bind_encode(uint32_t *msg, uint32_t self, uint32_t arg_name, const char *arg_interface, uint32_t arg_interface_len, uint32_t arg_version, uint32_t arg_id) {
+  msg[0] = self;
+  uint16_t size = wayland_wl_registry_bind_size(arg_interface_len);
+  msg[1] = (uint32_t)size << 16 | wayland_wl_registry_bind_opcode;
+  uint32_t *w = msg + 2;
+  *w++ = (uint32_t)arg_name;
+  *w++ = arg_interface_len;
+  memcpy(w, arg_interface, arg_interface_len);
+  memset((char *)w + arg_interface_len, 0, ((arg_interface_len + 3) & -4) - arg_interface_len);
+  w += (arg_interface_len + 3) / 4;
+  *w++ = arg_version;
+  *w++ = arg_id;
+  (void)w;
+}
+
+// wl_registry.global
+enum { wayland_wl_registry_global_opcode = 0 };
+typedef struct wayland_wl_registry_global_event_t wayland_wl_registry_global_event_t;
+struct wayland_wl_registry_global_event_t {
+  uint32_t name;
+  const char *interface;
+  uint32_t interface_len;
+  uint32_t version;
+};
+static inline int wayland_wl_registry_global_decode(const uint32_t *body, uint64_t body_len, wayland_wl_registry_global_event_t *event) {
+  if (body_len % 4 != 0 || body_len < 12)
+    return 0;
+  const uint32_t *end = body + body_len / 4;
+  const uint32_t *r = body;
+  event->name = *r++;
+  event->interface_len = *r++;
+  if ((uint64_t)(end - r) * 4 < event->interface_len)
+    return 0;
+  event->interface = (const void *)r;
+  if (event->interface_len == 0 || event->interface[event->interface_len - 1] != 0)
+    return 0;
+  r += (event->interface_len + 3) / 4;
+  if (r == end)
+    return 0;
+  event->version = *r++;
+  return r == end;
+}
+
+// wl_registry.global_remove
+enum { wayland_wl_registry_global_remove_opcode = 1 };
+typedef struct wayland_wl_registry_global_remove_event_t wayland_wl_registry_global_remove_event_t;
+struct wayland_wl_registry_global_remove_event_t {
+  uint32_t name;
+};
+static inline int wayland_wl_registry_global_remove_decode(const uint32_t *body, uint64_t body_len, wayland_wl_registry_global_remove_event_t *event) {
+  if (body_len != 4)
+    return 0;
+  const uint32_t *r = body;
+  event->name = *r++;
+  (void)r;
+  return 1;
+}
+
+// wl_registry events: file descriptors received along.
+static inline uint32_t wayland_wl_registry_event_fds(uint16_t opcode) {
+  (void)opcode;
+  return 0;
+}
+
+// wl_callback.done
+enum { wayland_wl_callback_done_opcode = 0 };
+typedef struct wayland_wl_callback_done_event_t wayland_wl_callback_done_event_t;
+struct wayland_wl_callback_done_event_t {
+  uint32_t callback_data;
+};
+static inline int wayland_wl_callback_done_decode(const uint32_t *body, uint64_t body_len, wayland_wl_callback_done_event_t *event) {
+  if (body_len != 4)
+    return 0;
+  const uint32_t *r = body;
+  event->callback_data = *r++;
+  (void)r;
+  return 1;
+}
+
+// wl_callback events: file descriptors received along.
+static inline uint32_t wayland_wl_callback_event_fds(uint16_t opcode) {
+  (void)opcode;
+  return 0;
+}
+
+// wl_compositor.create_surface
+enum { wayland_wl_compositor_create_surface_opcode = 0 };
+enum { wayland_wl_compositor_create_surface_size = 12 };
+static inline void wayland_wl_compositor_create_surface_encode(uint32_t *msg, uint32_t self, uint32_t arg_id) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_compositor_create_surface_size << 16 | wayland_wl_compositor_create_surface_opcode;
+  msg[2] = (uint32_t)arg_id;
+}
+
+// wl_compositor.create_region
+enum { wayland_wl_compositor_create_region_opcode = 1 };
+enum { wayland_wl_compositor_create_region_size = 12 };
+static inline void wayland_wl_compositor_create_region_encode(uint32_t *msg, uint32_t self, uint32_t arg_id) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_compositor_create_region_size << 16 | wayland_wl_compositor_create_region_opcode;
+  msg[2] = (uint32_t)arg_id;
+}
+
+// wl_shm_pool.create_buffer
+enum { wayland_wl_shm_pool_create_buffer_opcode = 0 };
+enum { wayland_wl_shm_pool_create_buffer_size = 32 };
+static inline void wayland_wl_shm_pool_create_buffer_encode(uint32_t *msg, uint32_t self, uint32_t arg_id, int32_t arg_offset, int32_t arg_width, int32_t arg_height, int32_t arg_stride, uint32_t arg_format) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_shm_pool_create_buffer_size << 16 | wayland_wl_shm_pool_create_buffer_opcode;
+  msg[2] = (uint32_t)arg_id;
+  msg[3] = (uint32_t)arg_offset;
+  msg[4] = (uint32_t)arg_width;
+  msg[5] = (uint32_t)arg_height;
+  msg[6] = (uint32_t)arg_stride;
+  msg[7] = (uint32_t)arg_format;
+}
+
+// wl_shm_pool.destroy
+enum { wayland_wl_shm_pool_destroy_opcode = 1 };
+enum { wayland_wl_shm_pool_destroy_size = 8 };
+static inline void wayland_wl_shm_pool_destroy_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_shm_pool_destroy_size << 16 | wayland_wl_shm_pool_destroy_opcode;
+}
+
+// wl_shm_pool.resize
+enum { wayland_wl_shm_pool_resize_opcode = 2 };
+enum { wayland_wl_shm_pool_resize_size = 12 };
+static inline void wayland_wl_shm_pool_resize_encode(uint32_t *msg, uint32_t self, int32_t arg_size) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_shm_pool_resize_size << 16 | wayland_wl_shm_pool_resize_opcode;
+  msg[2] = (uint32_t)arg_size;
+}
+
+// wl_shm.create_pool
+enum { wayland_wl_shm_create_pool_opcode = 0 };
+enum { wayland_wl_shm_create_pool_size = 16 };
+static inline void wayland_wl_shm_create_pool_encode(uint32_t *msg, uint32_t self, uint32_t arg_id, int32_t arg_size) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_shm_create_pool_size << 16 | wayland_wl_shm_create_pool_opcode;
+  msg[2] = (uint32_t)arg_id;
+  // `fd`: sent as ancillary data.
+  msg[3] = (uint32_t)arg_size;
+}
+
+// wl_shm.release
+enum { wayland_wl_shm_release_opcode = 1 };
+enum { wayland_wl_shm_release_size = 8 };
+static inline void wayland_wl_shm_release_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_shm_release_size << 16 | wayland_wl_shm_release_opcode;
+}
+
+// wl_shm.format
+enum { wayland_wl_shm_format_opcode = 0 };
+typedef struct wayland_wl_shm_format_event_t wayland_wl_shm_format_event_t;
+struct wayland_wl_shm_format_event_t {
+  uint32_t format;
+};
+static inline int wayland_wl_shm_format_decode(const uint32_t *body, uint64_t body_len, wayland_wl_shm_format_event_t *event) {
+  if (body_len != 4)
+    return 0;
+  const uint32_t *r = body;
+  event->format = *r++;
+  (void)r;
+  return 1;
+}
+
+// wl_shm events: file descriptors received along.
+static inline uint32_t wayland_wl_shm_event_fds(uint16_t opcode) {
+  (void)opcode;
+  return 0;
+}
+
+// wl_buffer.destroy
+enum { wayland_wl_buffer_destroy_opcode = 0 };
+enum { wayland_wl_buffer_destroy_size = 8 };
+static inline void wayland_wl_buffer_destroy_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_buffer_destroy_size << 16 | wayland_wl_buffer_destroy_opcode;
+}
+
+// wl_buffer.release
+enum { wayland_wl_buffer_release_opcode = 0 };
+
+// wl_buffer events: file descriptors received along.
+static inline uint32_t wayland_wl_buffer_event_fds(uint16_t opcode) {
+  (void)opcode;
+  return 0;
+}
+
+// wl_data_offer.accept
+enum { wayland_wl_data_offer_accept_opcode = 0 };
+static inline uint16_t wayland_wl_data_offer_accept_size(uint32_t arg_mime_type_len) {
+  return 16 + ((arg_mime_type_len + 3) & -4);
+}
+static inline void wayland_wl_data_offer_accept_encode(uint32_t *msg, uint32_t self, uint32_t arg_serial, const char *arg_mime_type, uint32_t arg_mime_type_len) {
+  msg[0] = self;
+  uint16_t size = wayland_wl_data_offer_accept_size(arg_mime_type_len);
+  msg[1] = (uint32_t)size << 16 | wayland_wl_data_offer_accept_opcode;
+  uint32_t *w = msg + 2;
+  *w++ = (uint32_t)arg_serial;
+  *w++ = arg_mime_type_len;
+  memcpy(w, arg_mime_type, arg_mime_type_len);
+  memset((char *)w + arg_mime_type_len, 0, ((arg_mime_type_len + 3) & -4) - arg_mime_type_len);
+  w += (arg_mime_type_len + 3) / 4;
+  (void)w;
+}
+
+// wl_data_offer.receive
+enum { wayland_wl_data_offer_receive_opcode = 1 };
+static inline uint16_t wayland_wl_data_offer_receive_size(uint32_t arg_mime_type_len) {
+  return 12 + ((arg_mime_type_len + 3) & -4);
+}
+static inline void wayland_wl_data_offer_receive_encode(uint32_t *msg, uint32_t self, const char *arg_mime_type, uint32_t arg_mime_type_len) {
+  msg[0] = self;
+  uint16_t size = wayland_wl_data_offer_receive_size(arg_mime_type_len);
+  msg[1] = (uint32_t)size << 16 | wayland_wl_data_offer_receive_opcode;
+  uint32_t *w = msg + 2;
+  *w++ = arg_mime_type_len;
+  memcpy(w, arg_mime_type, arg_mime_type_len);
+  memset((char *)w + arg_mime_type_len, 0, ((arg_mime_type_len + 3) & -4) - arg_mime_type_len);
+  w += (arg_mime_type_len + 3) / 4;
+  // `fd`: sent as ancillary data.
+  (void)w;
+}
+
+// wl_data_offer.destroy
+enum { wayland_wl_data_offer_destroy_opcode = 2 };
+enum { wayland_wl_data_offer_destroy_size = 8 };
+static inline void wayland_wl_data_offer_destroy_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_data_offer_destroy_size << 16 | wayland_wl_data_offer_destroy_opcode;
+}
+
+// wl_data_offer.finish
+enum { wayland_wl_data_offer_finish_opcode = 3 };
+enum { wayland_wl_data_offer_finish_size = 8 };
+static inline void wayland_wl_data_offer_finish_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_data_offer_finish_size << 16 | wayland_wl_data_offer_finish_opcode;
+}
+
+// wl_data_offer.set_actions
+enum { wayland_wl_data_offer_set_actions_opcode = 4 };
+enum { wayland_wl_data_offer_set_actions_size = 16 };
+static inline void wayland_wl_data_offer_set_actions_encode(uint32_t *msg, uint32_t self, uint32_t arg_dnd_actions, uint32_t arg_preferred_action) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_data_offer_set_actions_size << 16 | wayland_wl_data_offer_set_actions_opcode;
+  msg[2] = (uint32_t)arg_dnd_actions;
+  msg[3] = (uint32_t)arg_preferred_action;
+}
+
+// wl_data_offer.offer
+enum { wayland_wl_data_offer_offer_opcode = 0 };
+typedef struct wayland_wl_data_offer_offer_event_t wayland_wl_data_offer_offer_event_t;
+struct wayland_wl_data_offer_offer_event_t {
+  const char *mime_type;
+  uint32_t mime_type_len;
+};
+static inline int wayland_wl_data_offer_offer_decode(const uint32_t *body, uint64_t body_len, wayland_wl_data_offer_offer_event_t *event) {
+  if (body_len % 4 != 0 || body_len < 4)
+    return 0;
+  const uint32_t *end = body + body_len / 4;
+  const uint32_t *r = body;
+  event->mime_type_len = *r++;
+  if ((uint64_t)(end - r) * 4 < event->mime_type_len)
+    return 0;
+  event->mime_type = (const void *)r;
+  if (event->mime_type_len == 0 || event->mime_type[event->mime_type_len - 1] != 0)
+    return 0;
+  r += (event->mime_type_len + 3) / 4;
+  return r == end;
+}
+
+// wl_data_offer.source_actions
+enum { wayland_wl_data_offer_source_actions_opcode = 1 };
+typedef struct wayland_wl_data_offer_source_actions_event_t wayland_wl_data_offer_source_actions_event_t;
+struct wayland_wl_data_offer_source_actions_event_t {
+  uint32_t source_actions;
+};
+static inline int wayland_wl_data_offer_source_actions_decode(const uint32_t *body, uint64_t body_len, wayland_wl_data_offer_source_actions_event_t *event) {
+  if (body_len != 4)
+    return 0;
+  const uint32_t *r = body;
+  event->source_actions = *r++;
+  (void)r;
+  return 1;
+}
+
+// wl_data_offer.action
+enum { wayland_wl_data_offer_action_opcode = 2 };
+typedef struct wayland_wl_data_offer_action_event_t wayland_wl_data_offer_action_event_t;
+struct wayland_wl_data_offer_action_event_t {
+  uint32_t dnd_action;
+};
+static inline int wayland_wl_data_offer_action_decode(const uint32_t *body, uint64_t body_len, wayland_wl_data_offer_action_event_t *event) {
+  if (body_len != 4)
+    return 0;
+  const uint32_t *r = body;
+  event->dnd_action = *r++;
+  (void)r;
+  return 1;
+}
+
+// wl_data_offer events: file descriptors received along.
+static inline uint32_t wayland_wl_data_offer_event_fds(uint16_t opcode) {
+  (void)opcode;
+  return 0;
+}
+
+// wl_data_source.offer
+enum { wayland_wl_data_source_offer_opcode = 0 };
+static inline uint16_t wayland_wl_data_source_offer_size(uint32_t arg_mime_type_len) {
+  return 12 + ((arg_mime_type_len + 3) & -4);
+}
+static inline void wayland_wl_data_source_offer_encode(uint32_t *msg, uint32_t self, const char *arg_mime_type, uint32_t arg_mime_type_len) {
+  msg[0] = self;
+  uint16_t size = wayland_wl_data_source_offer_size(arg_mime_type_len);
+  msg[1] = (uint32_t)size << 16 | wayland_wl_data_source_offer_opcode;
+  uint32_t *w = msg + 2;
+  *w++ = arg_mime_type_len;
+  memcpy(w, arg_mime_type, arg_mime_type_len);
+  memset((char *)w + arg_mime_type_len, 0, ((arg_mime_type_len + 3) & -4) - arg_mime_type_len);
+  w += (arg_mime_type_len + 3) / 4;
+  (void)w;
+}
+
+// wl_data_source.destroy
+enum { wayland_wl_data_source_destroy_opcode = 1 };
+enum { wayland_wl_data_source_destroy_size = 8 };
+static inline void wayland_wl_data_source_destroy_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_data_source_destroy_size << 16 | wayland_wl_data_source_destroy_opcode;
+}
+
+// wl_data_source.set_actions
+enum { wayland_wl_data_source_set_actions_opcode = 2 };
+enum { wayland_wl_data_source_set_actions_size = 12 };
+static inline void wayland_wl_data_source_set_actions_encode(uint32_t *msg, uint32_t self, uint32_t arg_dnd_actions) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_data_source_set_actions_size << 16 | wayland_wl_data_source_set_actions_opcode;
+  msg[2] = (uint32_t)arg_dnd_actions;
+}
+
+// wl_data_source.target
+enum { wayland_wl_data_source_target_opcode = 0 };
+typedef struct wayland_wl_data_source_target_event_t wayland_wl_data_source_target_event_t;
+struct wayland_wl_data_source_target_event_t {
+  const char *mime_type;
+  uint32_t mime_type_len;
+};
+static inline int wayland_wl_data_source_target_decode(const uint32_t *body, uint64_t body_len, wayland_wl_data_source_target_event_t *event) {
+  if (body_len % 4 != 0 || body_len < 4)
+    return 0;
+  const uint32_t *end = body + body_len / 4;
+  const uint32_t *r = body;
+  event->mime_type_len = *r++;
+  if ((uint64_t)(end - r) * 4 < event->mime_type_len)
+    return 0;
+  event->mime_type = (const void *)r;
+  if (event->mime_type_len == 0)
+    event->mime_type = NULL;
+  else if (event->mime_type[event->mime_type_len - 1] != 0)
+    return 0;
+  r += (event->mime_type_len + 3) / 4;
+  return r == end;
+}
+
+// wl_data_source.send
+enum { wayland_wl_data_source_send_opcode = 1 };
+typedef struct wayland_wl_data_source_send_event_t wayland_wl_data_source_send_event_t;
+struct wayland_wl_data_source_send_event_t {
+  const char *mime_type;
+  uint32_t mime_type_len;
+  // `fd`: received as ancillary data.
+};
+static inline int wayland_wl_data_source_send_decode(const uint32_t *body, uint64_t body_len, wayland_wl_data_source_send_event_t *event) {
+  if (body_len % 4 != 0 || body_len < 4)
+    return 0;
+  const uint32_t *end = body + body_len / 4;
+  const uint32_t *r = body;
+  event->mime_type_len = *r++;
+  if ((uint64_t)(end - r) * 4 < event->mime_type_len)
+    return 0;
+  event->mime_type = (const void *)r;
+  if (event->mime_type_len == 0 || event->mime_type[event->mime_type_len - 1] != 0)
+    return 0;
+  r += (event->mime_type_len + 3) / 4;
+  return r == end;
+}
+
+// wl_data_source.cancelled
+enum { wayland_wl_data_source_cancelled_opcode = 2 };
+
+// wl_data_source.dnd_drop_performed
+enum { wayland_wl_data_source_dnd_drop_performed_opcode = 3 };
+
+// wl_data_source.dnd_finished
+enum { wayland_wl_data_source_dnd_finished_opcode = 4 };
+
+// wl_data_source.action
+enum { wayland_wl_data_source_action_opcode = 5 };
+typedef struct wayland_wl_data_source_action_event_t wayland_wl_data_source_action_event_t;
+struct wayland_wl_data_source_action_event_t {
+  uint32_t dnd_action;
+};
+static inline int wayland_wl_data_source_action_decode(const uint32_t *body, uint64_t body_len, wayland_wl_data_source_action_event_t *event) {
+  if (body_len != 4)
+    return 0;
+  const uint32_t *r = body;
+  event->dnd_action = *r++;
+  (void)r;
+  return 1;
+}
+
+// wl_data_source events: file descriptors received along.
+static inline uint32_t wayland_wl_data_source_event_fds(uint16_t opcode) {
+  switch (opcode) {
+  case wayland_wl_data_source_send_opcode:
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+// wl_data_device.start_drag
+enum { wayland_wl_data_device_start_drag_opcode = 0 };
+enum { wayland_wl_data_device_start_drag_size = 24 };
+static inline void wayland_wl_data_device_start_drag_encode(uint32_t *msg, uint32_t self, uint32_t arg_source, uint32_t arg_origin, uint32_t arg_icon, uint32_t arg_serial) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_data_device_start_drag_size << 16 | wayland_wl_data_device_start_drag_opcode;
+  msg[2] = (uint32_t)arg_source;
+  msg[3] = (uint32_t)arg_origin;
+  msg[4] = (uint32_t)arg_icon;
+  msg[5] = (uint32_t)arg_serial;
+}
+
+// wl_data_device.set_selection
+enum { wayland_wl_data_device_set_selection_opcode = 1 };
+enum { wayland_wl_data_device_set_selection_size = 16 };
+static inline void wayland_wl_data_device_set_selection_encode(uint32_t *msg, uint32_t self, uint32_t arg_source, uint32_t arg_serial) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_data_device_set_selection_size << 16 | wayland_wl_data_device_set_selection_opcode;
+  msg[2] = (uint32_t)arg_source;
+  msg[3] = (uint32_t)arg_serial;
+}
+
+// wl_data_device.release
+enum { wayland_wl_data_device_release_opcode = 2 };
+enum { wayland_wl_data_device_release_size = 8 };
+static inline void wayland_wl_data_device_release_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_data_device_release_size << 16 | wayland_wl_data_device_release_opcode;
+}
+
+// wl_data_device.data_offer
+enum { wayland_wl_data_device_data_offer_opcode = 0 };
+typedef struct wayland_wl_data_device_data_offer_event_t wayland_wl_data_device_data_offer_event_t;
+struct wayland_wl_data_device_data_offer_event_t {
+  uint32_t id;
+};
+static inline int wayland_wl_data_device_data_offer_decode(const uint32_t *body, uint64_t body_len, wayland_wl_data_device_data_offer_event_t *event) {
+  if (body_len != 4)
+    return 0;
+  const uint32_t *r = body;
+  event->id = *r++;
+  (void)r;
+  return 1;
+}
+
+// wl_data_device.enter
+enum { wayland_wl_data_device_enter_opcode = 1 };
+typedef struct wayland_wl_data_device_enter_event_t wayland_wl_data_device_enter_event_t;
+struct wayland_wl_data_device_enter_event_t {
+  uint32_t serial;
+  uint32_t surface;
+  int32_t x;
+  int32_t y;
+  uint32_t id;
+};
+static inline int wayland_wl_data_device_enter_decode(const uint32_t *body, uint64_t body_len, wayland_wl_data_device_enter_event_t *event) {
+  if (body_len != 20)
+    return 0;
+  const uint32_t *r = body;
+  event->serial = *r++;
+  event->surface = *r++;
+  event->x = (int32_t)*r++;
+  event->y = (int32_t)*r++;
+  event->id = *r++;
+  (void)r;
+  return 1;
+}
+
+// wl_data_device.leave
+enum { wayland_wl_data_device_leave_opcode = 2 };
+
+// wl_data_device.motion
+enum { wayland_wl_data_device_motion_opcode = 3 };
+typedef struct wayland_wl_data_device_motion_event_t wayland_wl_data_device_motion_event_t;
+struct wayland_wl_data_device_motion_event_t {
+  uint32_t time;
+  int32_t x;
+  int32_t y;
+};
+static inline int wayland_wl_data_device_motion_decode(const uint32_t *body, uint64_t body_len, wayland_wl_data_device_motion_event_t *event) {
+  if (body_len != 12)
+    return 0;
+  const uint32_t *r = body;
+  event->time = *r++;
+  event->x = (int32_t)*r++;
+  event->y = (int32_t)*r++;
+  (void)r;
+  return 1;
+}
+
+// wl_data_device.drop
+enum { wayland_wl_data_device_drop_opcode = 4 };
+
+// wl_data_device.selection
+enum { wayland_wl_data_device_selection_opcode = 5 };
+typedef struct wayland_wl_data_device_selection_event_t wayland_wl_data_device_selection_event_t;
+struct wayland_wl_data_device_selection_event_t {
+  uint32_t id;
+};
+static inline int wayland_wl_data_device_selection_decode(const uint32_t *body, uint64_t body_len, wayland_wl_data_device_selection_event_t *event) {
+  if (body_len != 4)
+    return 0;
+  const uint32_t *r = body;
+  event->id = *r++;
+  (void)r;
+  return 1;
+}
+
+// wl_data_device events: file descriptors received along.
+static inline uint32_t wayland_wl_data_device_event_fds(uint16_t opcode) {
+  (void)opcode;
+  return 0;
+}
+
+// wl_data_device_manager.create_data_source
+enum { wayland_wl_data_device_manager_create_data_source_opcode = 0 };
+enum { wayland_wl_data_device_manager_create_data_source_size = 12 };
+static inline void wayland_wl_data_device_manager_create_data_source_encode(uint32_t *msg, uint32_t self, uint32_t arg_id) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_data_device_manager_create_data_source_size << 16 | wayland_wl_data_device_manager_create_data_source_opcode;
+  msg[2] = (uint32_t)arg_id;
+}
+
+// wl_data_device_manager.get_data_device
+enum { wayland_wl_data_device_manager_get_data_device_opcode = 1 };
+enum { wayland_wl_data_device_manager_get_data_device_size = 16 };
+static inline void wayland_wl_data_device_manager_get_data_device_encode(uint32_t *msg, uint32_t self, uint32_t arg_id, uint32_t arg_seat) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_data_device_manager_get_data_device_size << 16 | wayland_wl_data_device_manager_get_data_device_opcode;
+  msg[2] = (uint32_t)arg_id;
+  msg[3] = (uint32_t)arg_seat;
+}
+
+// wl_shell.get_shell_surface
+enum { wayland_wl_shell_get_shell_surface_opcode = 0 };
+enum { wayland_wl_shell_get_shell_surface_size = 16 };
+static inline void wayland_wl_shell_get_shell_surface_encode(uint32_t *msg, uint32_t self, uint32_t arg_id, uint32_t arg_surface) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_shell_get_shell_surface_size << 16 | wayland_wl_shell_get_shell_surface_opcode;
+  msg[2] = (uint32_t)arg_id;
+  msg[3] = (uint32_t)arg_surface;
+}
+
+// wl_shell_surface.pong
+enum { wayland_wl_shell_surface_pong_opcode = 0 };
+enum { wayland_wl_shell_surface_pong_size = 12 };
+static inline void wayland_wl_shell_surface_pong_encode(uint32_t *msg, uint32_t self, uint32_t arg_serial) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_shell_surface_pong_size << 16 | wayland_wl_shell_surface_pong_opcode;
+  msg[2] = (uint32_t)arg_serial;
+}
+
+// wl_shell_surface.move
+enum { wayland_wl_shell_surface_move_opcode = 1 };
+enum { wayland_wl_shell_surface_move_size = 16 };
+static inline void wayland_wl_shell_surface_move_encode(uint32_t *msg, uint32_t self, uint32_t arg_seat, uint32_t arg_serial) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_shell_surface_move_size << 16 | wayland_wl_shell_surface_move_opcode;
+  msg[2] = (uint32_t)arg_seat;
+  msg[3] = (uint32_t)arg_serial;
+}
+
+// wl_shell_surface.resize
+enum { wayland_wl_shell_surface_resize_opcode = 2 };
+enum { wayland_wl_shell_surface_resize_size = 20 };
+static inline void wayland_wl_shell_surface_resize_encode(uint32_t *msg, uint32_t self, uint32_t arg_seat, uint32_t arg_serial, uint32_t arg_edges) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_shell_surface_resize_size << 16 | wayland_wl_shell_surface_resize_opcode;
+  msg[2] = (uint32_t)arg_seat;
+  msg[3] = (uint32_t)arg_serial;
+  msg[4] = (uint32_t)arg_edges;
+}
+
+// wl_shell_surface.set_toplevel
+enum { wayland_wl_shell_surface_set_toplevel_opcode = 3 };
+enum { wayland_wl_shell_surface_set_toplevel_size = 8 };
+static inline void wayland_wl_shell_surface_set_toplevel_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_shell_surface_set_toplevel_size << 16 | wayland_wl_shell_surface_set_toplevel_opcode;
+}
+
+// wl_shell_surface.set_transient
+enum { wayland_wl_shell_surface_set_transient_opcode = 4 };
+enum { wayland_wl_shell_surface_set_transient_size = 24 };
+static inline void wayland_wl_shell_surface_set_transient_encode(uint32_t *msg, uint32_t self, uint32_t arg_parent, int32_t arg_x, int32_t arg_y, uint32_t arg_flags) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_shell_surface_set_transient_size << 16 | wayland_wl_shell_surface_set_transient_opcode;
+  msg[2] = (uint32_t)arg_parent;
+  msg[3] = (uint32_t)arg_x;
+  msg[4] = (uint32_t)arg_y;
+  msg[5] = (uint32_t)arg_flags;
+}
+
+// wl_shell_surface.set_fullscreen
+enum { wayland_wl_shell_surface_set_fullscreen_opcode = 5 };
+enum { wayland_wl_shell_surface_set_fullscreen_size = 20 };
+static inline void wayland_wl_shell_surface_set_fullscreen_encode(uint32_t *msg, uint32_t self, uint32_t arg_method, uint32_t arg_framerate, uint32_t arg_output) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_shell_surface_set_fullscreen_size << 16 | wayland_wl_shell_surface_set_fullscreen_opcode;
+  msg[2] = (uint32_t)arg_method;
+  msg[3] = (uint32_t)arg_framerate;
+  msg[4] = (uint32_t)arg_output;
+}
+
+// wl_shell_surface.set_popup
+enum { wayland_wl_shell_surface_set_popup_opcode = 6 };
+enum { wayland_wl_shell_surface_set_popup_size = 32 };
+static inline void wayland_wl_shell_surface_set_popup_encode(uint32_t *msg, uint32_t self, uint32_t arg_seat, uint32_t arg_serial, uint32_t arg_parent, int32_t arg_x, int32_t arg_y, uint32_t arg_flags) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_shell_surface_set_popup_size << 16 | wayland_wl_shell_surface_set_popup_opcode;
+  msg[2] = (uint32_t)arg_seat;
+  msg[3] = (uint32_t)arg_serial;
+  msg[4] = (uint32_t)arg_parent;
+  msg[5] = (uint32_t)arg_x;
+  msg[6] = (uint32_t)arg_y;
+  msg[7] = (uint32_t)arg_flags;
+}
+
+// wl_shell_surface.set_maximized
+enum { wayland_wl_shell_surface_set_maximized_opcode = 7 };
+enum { wayland_wl_shell_surface_set_maximized_size = 12 };
+static inline void wayland_wl_shell_surface_set_maximized_encode(uint32_t *msg, uint32_t self, uint32_t arg_output) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_shell_surface_set_maximized_size << 16 | wayland_wl_shell_surface_set_maximized_opcode;
+  msg[2] = (uint32_t)arg_output;
+}
+
+// wl_shell_surface.set_title
+enum { wayland_wl_shell_surface_set_title_opcode = 8 };
+static inline uint16_t wayland_wl_shell_surface_set_title_size(uint32_t arg_title_len) {
+  return 12 + ((arg_title_len + 3) & -4);
+}
+static inline void wayland_wl_shell_surface_set_title_encode(uint32_t *msg, uint32_t self, const char *arg_title, uint32_t arg_title_len) {
+  msg[0] = self;
+  uint16_t size = wayland_wl_shell_surface_set_title_size(arg_title_len);
+  msg[1] = (uint32_t)size << 16 | wayland_wl_shell_surface_set_title_opcode;
+  uint32_t *w = msg + 2;
+  *w++ = arg_title_len;
+  memcpy(w, arg_title, arg_title_len);
+  memset((char *)w + arg_title_len, 0, ((arg_title_len + 3) & -4) - arg_title_len);
+  w += (arg_title_len + 3) / 4;
+  (void)w;
+}
+
+// wl_shell_surface.set_class
+enum { wayland_wl_shell_surface_set_class_opcode = 9 };
+static inline uint16_t wayland_wl_shell_surface_set_class_size(uint32_t arg_class__len) {
+  return 12 + ((arg_class__len + 3) & -4);
+}
+static inline void wayland_wl_shell_surface_set_class_encode(uint32_t *msg, uint32_t self, const char *arg_class_, uint32_t arg_class__len) {
+  msg[0] = self;
+  uint16_t size = wayland_wl_shell_surface_set_class_size(arg_class__len);
+  msg[1] = (uint32_t)size << 16 | wayland_wl_shell_surface_set_class_opcode;
+  uint32_t *w = msg + 2;
+  *w++ = arg_class__len;
+  memcpy(w, arg_class_, arg_class__len);
+  memset((char *)w + arg_class__len, 0, ((arg_class__len + 3) & -4) - arg_class__len);
+  w += (arg_class__len + 3) / 4;
+  (void)w;
+}
+
+// wl_shell_surface.ping
+enum { wayland_wl_shell_surface_ping_opcode = 0 };
+typedef struct wayland_wl_shell_surface_ping_event_t wayland_wl_shell_surface_ping_event_t;
+struct wayland_wl_shell_surface_ping_event_t {
+  uint32_t serial;
+};
+static inline int wayland_wl_shell_surface_ping_decode(const uint32_t *body, uint64_t body_len, wayland_wl_shell_surface_ping_event_t *event) {
+  if (body_len != 4)
+    return 0;
+  const uint32_t *r = body;
+  event->serial = *r++;
+  (void)r;
+  return 1;
+}
+
+// wl_shell_surface.configure
+enum { wayland_wl_shell_surface_configure_opcode = 1 };
+typedef struct wayland_wl_shell_surface_configure_event_t wayland_wl_shell_surface_configure_event_t;
+struct wayland_wl_shell_surface_configure_event_t {
+  uint32_t edges;
+  int32_t width;
+  int32_t height;
+};
+static inline int wayland_wl_shell_surface_configure_decode(const uint32_t *body, uint64_t body_len, wayland_wl_shell_surface_configure_event_t *event) {
+  if (body_len != 12)
+    return 0;
+  const uint32_t *r = body;
+  event->edges = *r++;
+  event->width = (int32_t)*r++;
+  event->height = (int32_t)*r++;
+  (void)r;
+  return 1;
+}
+
+// wl_shell_surface.popup_done
+enum { wayland_wl_shell_surface_popup_done_opcode = 2 };
+
+// wl_shell_surface events: file descriptors received along.
+static inline uint32_t wayland_wl_shell_surface_event_fds(uint16_t opcode) {
+  (void)opcode;
+  return 0;
+}
+
+// wl_surface.destroy
+enum { wayland_wl_surface_destroy_opcode = 0 };
+enum { wayland_wl_surface_destroy_size = 8 };
+static inline void wayland_wl_surface_destroy_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_surface_destroy_size << 16 | wayland_wl_surface_destroy_opcode;
+}
+
+// wl_surface.attach
+enum { wayland_wl_surface_attach_opcode = 1 };
+enum { wayland_wl_surface_attach_size = 20 };
+static inline void wayland_wl_surface_attach_encode(uint32_t *msg, uint32_t self, uint32_t arg_buffer, int32_t arg_x, int32_t arg_y) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_surface_attach_size << 16 | wayland_wl_surface_attach_opcode;
+  msg[2] = (uint32_t)arg_buffer;
+  msg[3] = (uint32_t)arg_x;
+  msg[4] = (uint32_t)arg_y;
+}
+
+// wl_surface.damage
+enum { wayland_wl_surface_damage_opcode = 2 };
+enum { wayland_wl_surface_damage_size = 24 };
+static inline void wayland_wl_surface_damage_encode(uint32_t *msg, uint32_t self, int32_t arg_x, int32_t arg_y, int32_t arg_width, int32_t arg_height) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_surface_damage_size << 16 | wayland_wl_surface_damage_opcode;
+  msg[2] = (uint32_t)arg_x;
+  msg[3] = (uint32_t)arg_y;
+  msg[4] = (uint32_t)arg_width;
+  msg[5] = (uint32_t)arg_height;
+}
+
+// wl_surface.frame
+enum { wayland_wl_surface_frame_opcode = 3 };
+enum { wayland_wl_surface_frame_size = 12 };
+static inline void wayland_wl_surface_frame_encode(uint32_t *msg, uint32_t self, uint32_t arg_callback) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_surface_frame_size << 16 | wayland_wl_surface_frame_opcode;
+  msg[2] = (uint32_t)arg_callback;
+}
+
+// wl_surface.set_opaque_region
+enum { wayland_wl_surface_set_opaque_region_opcode = 4 };
+enum { wayland_wl_surface_set_opaque_region_size = 12 };
+static inline void wayland_wl_surface_set_opaque_region_encode(uint32_t *msg, uint32_t self, uint32_t arg_region) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_surface_set_opaque_region_size << 16 | wayland_wl_surface_set_opaque_region_opcode;
+  msg[2] = (uint32_t)arg_region;
+}
+
+// wl_surface.set_input_region
+enum { wayland_wl_surface_set_input_region_opcode = 5 };
+enum { wayland_wl_surface_set_input_region_size = 12 };
+static inline void wayland_wl_surface_set_input_region_encode(uint32_t *msg, uint32_t self, uint32_t arg_region) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_surface_set_input_region_size << 16 | wayland_wl_surface_set_input_region_opcode;
+  msg[2] = (uint32_t)arg_region;
+}
+
+// wl_surface.commit
+enum { wayland_wl_surface_commit_opcode = 6 };
+enum { wayland_wl_surface_commit_size = 8 };
+static inline void wayland_wl_surface_commit_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_surface_commit_size << 16 | wayland_wl_surface_commit_opcode;
+}
+
+// wl_surface.set_buffer_transform
+enum { wayland_wl_surface_set_buffer_transform_opcode = 7 };
+enum { wayland_wl_surface_set_buffer_transform_size = 12 };
+static inline void wayland_wl_surface_set_buffer_transform_encode(uint32_t *msg, uint32_t self, int32_t arg_transform) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_surface_set_buffer_transform_size << 16 | wayland_wl_surface_set_buffer_transform_opcode;
+  msg[2] = (uint32_t)arg_transform;
+}
+
+// wl_surface.set_buffer_scale
+enum { wayland_wl_surface_set_buffer_scale_opcode = 8 };
+enum { wayland_wl_surface_set_buffer_scale_size = 12 };
+static inline void wayland_wl_surface_set_buffer_scale_encode(uint32_t *msg, uint32_t self, int32_t arg_scale) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_surface_set_buffer_scale_size << 16 | wayland_wl_surface_set_buffer_scale_opcode;
+  msg[2] = (uint32_t)arg_scale;
+}
+
+// wl_surface.damage_buffer
+enum { wayland_wl_surface_damage_buffer_opcode = 9 };
+enum { wayland_wl_surface_damage_buffer_size = 24 };
+static inline void wayland_wl_surface_damage_buffer_encode(uint32_t *msg, uint32_t self, int32_t arg_x, int32_t arg_y, int32_t arg_width, int32_t arg_height) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_surface_damage_buffer_size << 16 | wayland_wl_surface_damage_buffer_opcode;
+  msg[2] = (uint32_t)arg_x;
+  msg[3] = (uint32_t)arg_y;
+  msg[4] = (uint32_t)arg_width;
+  msg[5] = (uint32_t)arg_height;
+}
+
+// wl_surface.offset
+enum { wayland_wl_surface_offset_opcode = 10 };
+enum { wayland_wl_surface_offset_size = 16 };
+static inline void wayland_wl_surface_offset_encode(uint32_t *msg, uint32_t self, int32_t arg_x, int32_t arg_y) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_surface_offset_size << 16 | wayland_wl_surface_offset_opcode;
+  msg[2] = (uint32_t)arg_x;
+  msg[3] = (uint32_t)arg_y;
+}
+
+// wl_surface.enter
+enum { wayland_wl_surface_enter_opcode = 0 };
+typedef struct wayland_wl_surface_enter_event_t wayland_wl_surface_enter_event_t;
+struct wayland_wl_surface_enter_event_t {
+  uint32_t output;
+};
+static inline int wayland_wl_surface_enter_decode(const uint32_t *body, uint64_t body_len, wayland_wl_surface_enter_event_t *event) {
+  if (body_len != 4)
+    return 0;
+  const uint32_t *r = body;
+  event->output = *r++;
+  (void)r;
+  return 1;
+}
+
+// wl_surface.leave
+enum { wayland_wl_surface_leave_opcode = 1 };
+typedef struct wayland_wl_surface_leave_event_t wayland_wl_surface_leave_event_t;
+struct wayland_wl_surface_leave_event_t {
+  uint32_t output;
+};
+static inline int wayland_wl_surface_leave_decode(const uint32_t *body, uint64_t body_len, wayland_wl_surface_leave_event_t *event) {
+  if (body_len != 4)
+    return 0;
+  const uint32_t *r = body;
+  event->output = *r++;
+  (void)r;
+  return 1;
+}
+
+// wl_surface.preferred_buffer_scale
+enum { wayland_wl_surface_preferred_buffer_scale_opcode = 2 };
+typedef struct wayland_wl_surface_preferred_buffer_scale_event_t wayland_wl_surface_preferred_buffer_scale_event_t;
+struct wayland_wl_surface_preferred_buffer_scale_event_t {
+  int32_t factor;
+};
+static inline int wayland_wl_surface_preferred_buffer_scale_decode(const uint32_t *body, uint64_t body_len, wayland_wl_surface_preferred_buffer_scale_event_t *event) {
+  if (body_len != 4)
+    return 0;
+  const uint32_t *r = body;
+  event->factor = (int32_t)*r++;
+  (void)r;
+  return 1;
+}
+
+// wl_surface.preferred_buffer_transform
+enum { wayland_wl_surface_preferred_buffer_transform_opcode = 3 };
+typedef struct wayland_wl_surface_preferred_buffer_transform_event_t wayland_wl_surface_preferred_buffer_transform_event_t;
+struct wayland_wl_surface_preferred_buffer_transform_event_t {
+  uint32_t transform;
+};
+static inline int wayland_wl_surface_preferred_buffer_transform_decode(const uint32_t *body, uint64_t body_len, wayland_wl_surface_preferred_buffer_transform_event_t *event) {
+  if (body_len != 4)
+    return 0;
+  const uint32_t *r = body;
+  event->transform = *r++;
+  (void)r;
+  return 1;
+}
+
+// wl_surface events: file descriptors received along.
+static inline uint32_t wayland_wl_surface_event_fds(uint16_t opcode) {
+  (void)opcode;
+  return 0;
+}
+
+// wl_seat.get_pointer
+enum { wayland_wl_seat_get_pointer_opcode = 0 };
+enum { wayland_wl_seat_get_pointer_size = 12 };
+static inline void wayland_wl_seat_get_pointer_encode(uint32_t *msg, uint32_t self, uint32_t arg_id) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_seat_get_pointer_size << 16 | wayland_wl_seat_get_pointer_opcode;
+  msg[2] = (uint32_t)arg_id;
+}
+
+// wl_seat.get_keyboard
+enum { wayland_wl_seat_get_keyboard_opcode = 1 };
+enum { wayland_wl_seat_get_keyboard_size = 12 };
+static inline void wayland_wl_seat_get_keyboard_encode(uint32_t *msg, uint32_t self, uint32_t arg_id) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_seat_get_keyboard_size << 16 | wayland_wl_seat_get_keyboard_opcode;
+  msg[2] = (uint32_t)arg_id;
+}
+
+// wl_seat.get_touch
+enum { wayland_wl_seat_get_touch_opcode = 2 };
+enum { wayland_wl_seat_get_touch_size = 12 };
+static inline void wayland_wl_seat_get_touch_encode(uint32_t *msg, uint32_t self, uint32_t arg_id) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_seat_get_touch_size << 16 | wayland_wl_seat_get_touch_opcode;
+  msg[2] = (uint32_t)arg_id;
+}
+
+// wl_seat.release
+enum { wayland_wl_seat_release_opcode = 3 };
+enum { wayland_wl_seat_release_size = 8 };
+static inline void wayland_wl_seat_release_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_seat_release_size << 16 | wayland_wl_seat_release_opcode;
+}
+
+// wl_seat.capabilities
+enum { wayland_wl_seat_capabilities_opcode = 0 };
+typedef struct wayland_wl_seat_capabilities_event_t wayland_wl_seat_capabilities_event_t;
+struct wayland_wl_seat_capabilities_event_t {
+  uint32_t capabilities;
+};
+static inline int wayland_wl_seat_capabilities_decode(const uint32_t *body, uint64_t body_len, wayland_wl_seat_capabilities_event_t *event) {
+  if (body_len != 4)
+    return 0;
+  const uint32_t *r = body;
+  event->capabilities = *r++;
+  (void)r;
+  return 1;
+}
+
+// wl_seat.name
+enum { wayland_wl_seat_name_opcode = 1 };
+typedef struct wayland_wl_seat_name_event_t wayland_wl_seat_name_event_t;
+struct wayland_wl_seat_name_event_t {
+  const char *name;
+  uint32_t name_len;
+};
+static inline int wayland_wl_seat_name_decode(const uint32_t *body, uint64_t body_len, wayland_wl_seat_name_event_t *event) {
+  if (body_len % 4 != 0 || body_len < 4)
+    return 0;
+  const uint32_t *end = body + body_len / 4;
+  const uint32_t *r = body;
+  event->name_len = *r++;
+  if ((uint64_t)(end - r) * 4 < event->name_len)
+    return 0;
+  event->name = (const void *)r;
+  if (event->name_len == 0 || event->name[event->name_len - 1] != 0)
+    return 0;
+  r += (event->name_len + 3) / 4;
+  return r == end;
+}
+
+// wl_seat events: file descriptors received along.
+static inline uint32_t wayland_wl_seat_event_fds(uint16_t opcode) {
+  (void)opcode;
+  return 0;
+}
+
+// wl_pointer.set_cursor
+enum { wayland_wl_pointer_set_cursor_opcode = 0 };
+enum { wayland_wl_pointer_set_cursor_size = 24 };
+static inline void wayland_wl_pointer_set_cursor_encode(uint32_t *msg, uint32_t self, uint32_t arg_serial, uint32_t arg_surface, int32_t arg_hotspot_x, int32_t arg_hotspot_y) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_pointer_set_cursor_size << 16 | wayland_wl_pointer_set_cursor_opcode;
+  msg[2] = (uint32_t)arg_serial;
+  msg[3] = (uint32_t)arg_surface;
+  msg[4] = (uint32_t)arg_hotspot_x;
+  msg[5] = (uint32_t)arg_hotspot_y;
+}
+
+// wl_pointer.release
+enum { wayland_wl_pointer_release_opcode = 1 };
+enum { wayland_wl_pointer_release_size = 8 };
+static inline void wayland_wl_pointer_release_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_pointer_release_size << 16 | wayland_wl_pointer_release_opcode;
+}
+
+// wl_pointer.enter
+enum { wayland_wl_pointer_enter_opcode = 0 };
+typedef struct wayland_wl_pointer_enter_event_t wayland_wl_pointer_enter_event_t;
+struct wayland_wl_pointer_enter_event_t {
+  uint32_t serial;
+  uint32_t surface;
+  int32_t surface_x;
+  int32_t surface_y;
+};
+static inline int wayland_wl_pointer_enter_decode(const uint32_t *body, uint64_t body_len, wayland_wl_pointer_enter_event_t *event) {
+  if (body_len != 16)
+    return 0;
+  const uint32_t *r = body;
+  event->serial = *r++;
+  event->surface = *r++;
+  event->surface_x = (int32_t)*r++;
+  event->surface_y = (int32_t)*r++;
+  (void)r;
+  return 1;
+}
+
+// wl_pointer.leave
+enum { wayland_wl_pointer_leave_opcode = 1 };
+typedef struct wayland_wl_pointer_leave_event_t wayland_wl_pointer_leave_event_t;
+struct wayland_wl_pointer_leave_event_t {
+  uint32_t serial;
+  uint32_t surface;
+};
+static inline int wayland_wl_pointer_leave_decode(const uint32_t *body, uint64_t body_len, wayland_wl_pointer_leave_event_t *event) {
+  if (body_len != 8)
+    return 0;
+  const uint32_t *r = body;
+  event->serial = *r++;
+  event->surface = *r++;
+  (void)r;
+  return 1;
+}
+
+// wl_pointer.motion
+enum { wayland_wl_pointer_motion_opcode = 2 };
+typedef struct wayland_wl_pointer_motion_event_t wayland_wl_pointer_motion_event_t;
+struct wayland_wl_pointer_motion_event_t {
+  uint32_t time;
+  int32_t surface_x;
+  int32_t surface_y;
+};
+static inline int wayland_wl_pointer_motion_decode(const uint32_t *body, uint64_t body_len, wayland_wl_pointer_motion_event_t *event) {
+  if (body_len != 12)
+    return 0;
+  const uint32_t *r = body;
+  event->time = *r++;
+  event->surface_x = (int32_t)*r++;
+  event->surface_y = (int32_t)*r++;
+  (void)r;
+  return 1;
+}
+
+// wl_pointer.button
+enum { wayland_wl_pointer_button_opcode = 3 };
+typedef struct wayland_wl_pointer_button_event_t wayland_wl_pointer_button_event_t;
+struct wayland_wl_pointer_button_event_t {
+  uint32_t serial;
+  uint32_t time;
+  uint32_t button;
+  uint32_t state;
+};
+static inline int wayland_wl_pointer_button_decode(const uint32_t *body, uint64_t body_len, wayland_wl_pointer_button_event_t *event) {
+  if (body_len != 16)
+    return 0;
+  const uint32_t *r = body;
+  event->serial = *r++;
+  event->time = *r++;
+  event->button = *r++;
+  event->state = *r++;
+  (void)r;
+  return 1;
+}
+
+// wl_pointer.axis
+enum { wayland_wl_pointer_axis_opcode = 4 };
+typedef struct wayland_wl_pointer_axis_event_t wayland_wl_pointer_axis_event_t;
+struct wayland_wl_pointer_axis_event_t {
+  uint32_t time;
+  uint32_t axis;
+  int32_t value;
+};
+static inline int wayland_wl_pointer_axis_decode(const uint32_t *body, uint64_t body_len, wayland_wl_pointer_axis_event_t *event) {
+  if (body_len != 12)
+    return 0;
+  const uint32_t *r = body;
+  event->time = *r++;
+  event->axis = *r++;
+  event->value = (int32_t)*r++;
+  (void)r;
+  return 1;
+}
+
+// wl_pointer.frame
+enum { wayland_wl_pointer_frame_opcode = 5 };
+
+// wl_pointer.axis_source
+enum { wayland_wl_pointer_axis_source_opcode = 6 };
+typedef struct wayland_wl_pointer_axis_source_event_t wayland_wl_pointer_axis_source_event_t;
+struct wayland_wl_pointer_axis_source_event_t {
+  uint32_t axis_source;
+};
+static inline int wayland_wl_pointer_axis_source_decode(const uint32_t *body, uint64_t body_len, wayland_wl_pointer_axis_source_event_t *event) {
+  if (body_len != 4)
+    return 0;
+  const uint32_t *r = body;
+  event->axis_source = *r++;
+  (void)r;
+  return 1;
+}
+
+// wl_pointer.axis_stop
+enum { wayland_wl_pointer_axis_stop_opcode = 7 };
+typedef struct wayland_wl_pointer_axis_stop_event_t wayland_wl_pointer_axis_stop_event_t;
+struct wayland_wl_pointer_axis_stop_event_t {
+  uint32_t time;
+  uint32_t axis;
+};
+static inline int wayland_wl_pointer_axis_stop_decode(const uint32_t *body, uint64_t body_len, wayland_wl_pointer_axis_stop_event_t *event) {
+  if (body_len != 8)
+    return 0;
+  const uint32_t *r = body;
+  event->time = *r++;
+  event->axis = *r++;
+  (void)r;
+  return 1;
+}
+
+// wl_pointer.axis_discrete
+enum { wayland_wl_pointer_axis_discrete_opcode = 8 };
+typedef struct wayland_wl_pointer_axis_discrete_event_t wayland_wl_pointer_axis_discrete_event_t;
+struct wayland_wl_pointer_axis_discrete_event_t {
+  uint32_t axis;
+  int32_t discrete;
+};
+static inline int wayland_wl_pointer_axis_discrete_decode(const uint32_t *body, uint64_t body_len, wayland_wl_pointer_axis_discrete_event_t *event) {
+  if (body_len != 8)
+    return 0;
+  const uint32_t *r = body;
+  event->axis = *r++;
+  event->discrete = (int32_t)*r++;
+  (void)r;
+  return 1;
+}
+
+// wl_pointer.axis_value120
+enum { wayland_wl_pointer_axis_value120_opcode = 9 };
+typedef struct wayland_wl_pointer_axis_value120_event_t wayland_wl_pointer_axis_value120_event_t;
+struct wayland_wl_pointer_axis_value120_event_t {
+  uint32_t axis;
+  int32_t value120;
+};
+static inline int wayland_wl_pointer_axis_value120_decode(const uint32_t *body, uint64_t body_len, wayland_wl_pointer_axis_value120_event_t *event) {
+  if (body_len != 8)
+    return 0;
+  const uint32_t *r = body;
+  event->axis = *r++;
+  event->value120 = (int32_t)*r++;
+  (void)r;
+  return 1;
+}
+
+// wl_pointer.axis_relative_direction
+enum { wayland_wl_pointer_axis_relative_direction_opcode = 10 };
+typedef struct wayland_wl_pointer_axis_relative_direction_event_t wayland_wl_pointer_axis_relative_direction_event_t;
+struct wayland_wl_pointer_axis_relative_direction_event_t {
+  uint32_t axis;
+  uint32_t direction;
+};
+static inline int wayland_wl_pointer_axis_relative_direction_decode(const uint32_t *body, uint64_t body_len, wayland_wl_pointer_axis_relative_direction_event_t *event) {
+  if (body_len != 8)
+    return 0;
+  const uint32_t *r = body;
+  event->axis = *r++;
+  event->direction = *r++;
+  (void)r;
+  return 1;
+}
+
+// wl_pointer events: file descriptors received along.
+static inline uint32_t wayland_wl_pointer_event_fds(uint16_t opcode) {
+  (void)opcode;
+  return 0;
+}
+
+// wl_keyboard.release
+enum { wayland_wl_keyboard_release_opcode = 0 };
+enum { wayland_wl_keyboard_release_size = 8 };
+static inline void wayland_wl_keyboard_release_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_keyboard_release_size << 16 | wayland_wl_keyboard_release_opcode;
+}
+
+// wl_keyboard.keymap
+enum { wayland_wl_keyboard_keymap_opcode = 0 };
+typedef struct wayland_wl_keyboard_keymap_event_t wayland_wl_keyboard_keymap_event_t;
+struct wayland_wl_keyboard_keymap_event_t {
+  uint32_t format;
+  // `fd`: received as ancillary data.
+  uint32_t size;
+};
+static inline int wayland_wl_keyboard_keymap_decode(const uint32_t *body, uint64_t body_len, wayland_wl_keyboard_keymap_event_t *event) {
+  if (body_len != 8)
+    return 0;
+  const uint32_t *r = body;
+  event->format = *r++;
+  event->size = *r++;
+  (void)r;
+  return 1;
+}
+
+// wl_keyboard.enter
+enum { wayland_wl_keyboard_enter_opcode = 1 };
+typedef struct wayland_wl_keyboard_enter_event_t wayland_wl_keyboard_enter_event_t;
+struct wayland_wl_keyboard_enter_event_t {
+  uint32_t serial;
+  uint32_t surface;
+  const void *keys;
+  uint32_t keys_len;
+};
+static inline int wayland_wl_keyboard_enter_decode(const uint32_t *body, uint64_t body_len, wayland_wl_keyboard_enter_event_t *event) {
+  if (body_len % 4 != 0 || body_len < 12)
+    return 0;
+  const uint32_t *end = body + body_len / 4;
+  const uint32_t *r = body;
+  event->serial = *r++;
+  event->surface = *r++;
+  event->keys_len = *r++;
+  if ((uint64_t)(end - r) * 4 < event->keys_len)
+    return 0;
+  event->keys = (const void *)r;
+  r += (event->keys_len + 3) / 4;
+  return r == end;
+}
+
+// wl_keyboard.leave
+enum { wayland_wl_keyboard_leave_opcode = 2 };
+typedef struct wayland_wl_keyboard_leave_event_t wayland_wl_keyboard_leave_event_t;
+struct wayland_wl_keyboard_leave_event_t {
+  uint32_t serial;
+  uint32_t surface;
+};
+static inline int wayland_wl_keyboard_leave_decode(const uint32_t *body, uint64_t body_len, wayland_wl_keyboard_leave_event_t *event) {
+  if (body_len != 8)
+    return 0;
+  const uint32_t *r = body;
+  event->serial = *r++;
+  event->surface = *r++;
+  (void)r;
+  return 1;
+}
+
+// wl_keyboard.key
+enum { wayland_wl_keyboard_key_opcode = 3 };
+typedef struct wayland_wl_keyboard_key_event_t wayland_wl_keyboard_key_event_t;
+struct wayland_wl_keyboard_key_event_t {
+  uint32_t serial;
+  uint32_t time;
+  uint32_t key;
+  uint32_t state;
+};
+static inline int wayland_wl_keyboard_key_decode(const uint32_t *body, uint64_t body_len, wayland_wl_keyboard_key_event_t *event) {
+  if (body_len != 16)
+    return 0;
+  const uint32_t *r = body;
+  event->serial = *r++;
+  event->time = *r++;
+  event->key = *r++;
+  event->state = *r++;
+  (void)r;
+  return 1;
+}
+
+// wl_keyboard.modifiers
+enum { wayland_wl_keyboard_modifiers_opcode = 4 };
+typedef struct wayland_wl_keyboard_modifiers_event_t wayland_wl_keyboard_modifiers_event_t;
+struct wayland_wl_keyboard_modifiers_event_t {
+  uint32_t serial;
+  uint32_t mods_depressed;
+  uint32_t mods_latched;
+  uint32_t mods_locked;
+  uint32_t group;
+};
+static inline int wayland_wl_keyboard_modifiers_decode(const uint32_t *body, uint64_t body_len, wayland_wl_keyboard_modifiers_event_t *event) {
+  if (body_len != 20)
+    return 0;
+  const uint32_t *r = body;
+  event->serial = *r++;
+  event->mods_depressed = *r++;
+  event->mods_latched = *r++;
+  event->mods_locked = *r++;
+  event->group = *r++;
+  (void)r;
+  return 1;
+}
+
+// wl_keyboard.repeat_info
+enum { wayland_wl_keyboard_repeat_info_opcode = 5 };
+typedef struct wayland_wl_keyboard_repeat_info_event_t wayland_wl_keyboard_repeat_info_event_t;
+struct wayland_wl_keyboard_repeat_info_event_t {
+  int32_t rate;
+  int32_t delay;
+};
+static inline int wayland_wl_keyboard_repeat_info_decode(const uint32_t *body, uint64_t body_len, wayland_wl_keyboard_repeat_info_event_t *event) {
+  if (body_len != 8)
+    return 0;
+  const uint32_t *r = body;
+  event->rate = (int32_t)*r++;
+  event->delay = (int32_t)*r++;
+  (void)r;
+  return 1;
+}
+
+// wl_keyboard events: file descriptors received along.
+static inline uint32_t wayland_wl_keyboard_event_fds(uint16_t opcode) {
+  switch (opcode) {
+  case wayland_wl_keyboard_keymap_opcode:
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+// wl_touch.release
+enum { wayland_wl_touch_release_opcode = 0 };
+enum { wayland_wl_touch_release_size = 8 };
+static inline void wayland_wl_touch_release_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_touch_release_size << 16 | wayland_wl_touch_release_opcode;
+}
+
+// wl_touch.down
+enum { wayland_wl_touch_down_opcode = 0 };
+typedef struct wayland_wl_touch_down_event_t wayland_wl_touch_down_event_t;
+struct wayland_wl_touch_down_event_t {
+  uint32_t serial;
+  uint32_t time;
+  uint32_t surface;
+  int32_t id;
+  int32_t x;
+  int32_t y;
+};
+static inline int wayland_wl_touch_down_decode(const uint32_t *body, uint64_t body_len, wayland_wl_touch_down_event_t *event) {
+  if (body_len != 24)
+    return 0;
+  const uint32_t *r = body;
+  event->serial = *r++;
+  event->time = *r++;
+  event->surface = *r++;
+  event->id = (int32_t)*r++;
+  event->x = (int32_t)*r++;
+  event->y = (int32_t)*r++;
+  (void)r;
+  return 1;
+}
+
+// wl_touch.up
+enum { wayland_wl_touch_up_opcode = 1 };
+typedef struct wayland_wl_touch_up_event_t wayland_wl_touch_up_event_t;
+struct wayland_wl_touch_up_event_t {
+  uint32_t serial;
+  uint32_t time;
+  int32_t id;
+};
+static inline int wayland_wl_touch_up_decode(const uint32_t *body, uint64_t body_len, wayland_wl_touch_up_event_t *event) {
+  if (body_len != 12)
+    return 0;
+  const uint32_t *r = body;
+  event->serial = *r++;
+  event->time = *r++;
+  event->id = (int32_t)*r++;
+  (void)r;
+  return 1;
+}
+
+// wl_touch.motion
+enum { wayland_wl_touch_motion_opcode = 2 };
+typedef struct wayland_wl_touch_motion_event_t wayland_wl_touch_motion_event_t;
+struct wayland_wl_touch_motion_event_t {
+  uint32_t time;
+  int32_t id;
+  int32_t x;
+  int32_t y;
+};
+static inline int wayland_wl_touch_motion_decode(const uint32_t *body, uint64_t body_len, wayland_wl_touch_motion_event_t *event) {
+  if (body_len != 16)
+    return 0;
+  const uint32_t *r = body;
+  event->time = *r++;
+  event->id = (int32_t)*r++;
+  event->x = (int32_t)*r++;
+  event->y = (int32_t)*r++;
+  (void)r;
+  return 1;
+}
+
+// wl_touch.frame
+enum { wayland_wl_touch_frame_opcode = 3 };
+
+// wl_touch.cancel
+enum { wayland_wl_touch_cancel_opcode = 4 };
+
+// wl_touch.shape
+enum { wayland_wl_touch_shape_opcode = 5 };
+typedef struct wayland_wl_touch_shape_event_t wayland_wl_touch_shape_event_t;
+struct wayland_wl_touch_shape_event_t {
+  int32_t id;
+  int32_t major;
+  int32_t minor;
+};
+static inline int wayland_wl_touch_shape_decode(const uint32_t *body, uint64_t body_len, wayland_wl_touch_shape_event_t *event) {
+  if (body_len != 12)
+    return 0;
+  const uint32_t *r = body;
+  event->id = (int32_t)*r++;
+  event->major = (int32_t)*r++;
+  event->minor = (int32_t)*r++;
+  (void)r;
+  return 1;
+}
+
+// wl_touch.orientation
+enum { wayland_wl_touch_orientation_opcode = 6 };
+typedef struct wayland_wl_touch_orientation_event_t wayland_wl_touch_orientation_event_t;
+struct wayland_wl_touch_orientation_event_t {
+  int32_t id;
+  int32_t orientation;
+};
+static inline int wayland_wl_touch_orientation_decode(const uint32_t *body, uint64_t body_len, wayland_wl_touch_orientation_event_t *event) {
+  if (body_len != 8)
+    return 0;
+  const uint32_t *r = body;
+  event->id = (int32_t)*r++;
+  event->orientation = (int32_t)*r++;
+  (void)r;
+  return 1;
+}
+
+// wl_touch events: file descriptors received along.
+static inline uint32_t wayland_wl_touch_event_fds(uint16_t opcode) {
+  (void)opcode;
+  return 0;
+}
+
+// wl_output.release
+enum { wayland_wl_output_release_opcode = 0 };
+enum { wayland_wl_output_release_size = 8 };
+static inline void wayland_wl_output_release_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_output_release_size << 16 | wayland_wl_output_release_opcode;
+}
+
+// wl_output.geometry
+enum { wayland_wl_output_geometry_opcode = 0 };
+typedef struct wayland_wl_output_geometry_event_t wayland_wl_output_geometry_event_t;
+struct wayland_wl_output_geometry_event_t {
+  int32_t x;
+  int32_t y;
+  int32_t physical_width;
+  int32_t physical_height;
+  int32_t subpixel;
+  const char *make;
+  uint32_t make_len;
+  const char *model;
+  uint32_t model_len;
+  int32_t transform;
+};
+static inline int wayland_wl_output_geometry_decode(const uint32_t *body, uint64_t body_len, wayland_wl_output_geometry_event_t *event) {
+  if (body_len % 4 != 0 || body_len < 32)
+    return 0;
+  const uint32_t *end = body + body_len / 4;
+  const uint32_t *r = body;
+  event->x = (int32_t)*r++;
+  event->y = (int32_t)*r++;
+  event->physical_width = (int32_t)*r++;
+  event->physical_height = (int32_t)*r++;
+  event->subpixel = (int32_t)*r++;
+  event->make_len = *r++;
+  if ((uint64_t)(end - r) * 4 < event->make_len)
+    return 0;
+  event->make = (const void *)r;
+  if (event->make_len == 0 || event->make[event->make_len - 1] != 0)
+    return 0;
+  r += (event->make_len + 3) / 4;
+  if (r == end)
+    return 0;
+  event->model_len = *r++;
+  if ((uint64_t)(end - r) * 4 < event->model_len)
+    return 0;
+  event->model = (const void *)r;
+  if (event->model_len == 0 || event->model[event->model_len - 1] != 0)
+    return 0;
+  r += (event->model_len + 3) / 4;
+  if (r == end)
+    return 0;
+  event->transform = (int32_t)*r++;
+  return r == end;
+}
+
+// wl_output.mode
+enum { wayland_wl_output_mode_opcode = 1 };
+typedef struct wayland_wl_output_mode_event_t wayland_wl_output_mode_event_t;
+struct wayland_wl_output_mode_event_t {
+  uint32_t flags;
+  int32_t width;
+  int32_t height;
+  int32_t refresh;
+};
+static inline int wayland_wl_output_mode_decode(const uint32_t *body, uint64_t body_len, wayland_wl_output_mode_event_t *event) {
+  if (body_len != 16)
+    return 0;
+  const uint32_t *r = body;
+  event->flags = *r++;
+  event->width = (int32_t)*r++;
+  event->height = (int32_t)*r++;
+  event->refresh = (int32_t)*r++;
+  (void)r;
+  return 1;
+}
+
+// wl_output.done
+enum { wayland_wl_output_done_opcode = 2 };
+
+// wl_output.scale
+enum { wayland_wl_output_scale_opcode = 3 };
+typedef struct wayland_wl_output_scale_event_t wayland_wl_output_scale_event_t;
+struct wayland_wl_output_scale_event_t {
+  int32_t factor;
+};
+static inline int wayland_wl_output_scale_decode(const uint32_t *body, uint64_t body_len, wayland_wl_output_scale_event_t *event) {
+  if (body_len != 4)
+    return 0;
+  const uint32_t *r = body;
+  event->factor = (int32_t)*r++;
+  (void)r;
+  return 1;
+}
+
+// wl_output.name
+enum { wayland_wl_output_name_opcode = 4 };
+typedef struct wayland_wl_output_name_event_t wayland_wl_output_name_event_t;
+struct wayland_wl_output_name_event_t {
+  const char *name;
+  uint32_t name_len;
+};
+static inline int wayland_wl_output_name_decode(const uint32_t *body, uint64_t body_len, wayland_wl_output_name_event_t *event) {
+  if (body_len % 4 != 0 || body_len < 4)
+    return 0;
+  const uint32_t *end = body + body_len / 4;
+  const uint32_t *r = body;
+  event->name_len = *r++;
+  if ((uint64_t)(end - r) * 4 < event->name_len)
+    return 0;
+  event->name = (const void *)r;
+  if (event->name_len == 0 || event->name[event->name_len - 1] != 0)
+    return 0;
+  r += (event->name_len + 3) / 4;
+  return r == end;
+}
+
+// wl_output.description
+enum { wayland_wl_output_description_opcode = 5 };
+typedef struct wayland_wl_output_description_event_t wayland_wl_output_description_event_t;
+struct wayland_wl_output_description_event_t {
+  const char *description;
+  uint32_t description_len;
+};
+static inline int wayland_wl_output_description_decode(const uint32_t *body, uint64_t body_len, wayland_wl_output_description_event_t *event) {
+  if (body_len % 4 != 0 || body_len < 4)
+    return 0;
+  const uint32_t *end = body + body_len / 4;
+  const uint32_t *r = body;
+  event->description_len = *r++;
+  if ((uint64_t)(end - r) * 4 < event->description_len)
+    return 0;
+  event->description = (const void *)r;
+  if (event->description_len == 0 || event->description[event->description_len - 1] != 0)
+    return 0;
+  r += (event->description_len + 3) / 4;
+  return r == end;
+}
+
+// wl_output events: file descriptors received along.
+static inline uint32_t wayland_wl_output_event_fds(uint16_t opcode) {
+  (void)opcode;
+  return 0;
+}
+
+// wl_region.destroy
+enum { wayland_wl_region_destroy_opcode = 0 };
+enum { wayland_wl_region_destroy_size = 8 };
+static inline void wayland_wl_region_destroy_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_region_destroy_size << 16 | wayland_wl_region_destroy_opcode;
+}
+
+// wl_region.add
+enum { wayland_wl_region_add_opcode = 1 };
+enum { wayland_wl_region_add_size = 24 };
+static inline void wayland_wl_region_add_encode(uint32_t *msg, uint32_t self, int32_t arg_x, int32_t arg_y, int32_t arg_width, int32_t arg_height) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_region_add_size << 16 | wayland_wl_region_add_opcode;
+  msg[2] = (uint32_t)arg_x;
+  msg[3] = (uint32_t)arg_y;
+  msg[4] = (uint32_t)arg_width;
+  msg[5] = (uint32_t)arg_height;
+}
+
+// wl_region.subtract
+enum { wayland_wl_region_subtract_opcode = 2 };
+enum { wayland_wl_region_subtract_size = 24 };
+static inline void wayland_wl_region_subtract_encode(uint32_t *msg, uint32_t self, int32_t arg_x, int32_t arg_y, int32_t arg_width, int32_t arg_height) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_region_subtract_size << 16 | wayland_wl_region_subtract_opcode;
+  msg[2] = (uint32_t)arg_x;
+  msg[3] = (uint32_t)arg_y;
+  msg[4] = (uint32_t)arg_width;
+  msg[5] = (uint32_t)arg_height;
+}
+
+// wl_subcompositor.destroy
+enum { wayland_wl_subcompositor_destroy_opcode = 0 };
+enum { wayland_wl_subcompositor_destroy_size = 8 };
+static inline void wayland_wl_subcompositor_destroy_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_subcompositor_destroy_size << 16 | wayland_wl_subcompositor_destroy_opcode;
+}
+
+// wl_subcompositor.get_subsurface
+enum { wayland_wl_subcompositor_get_subsurface_opcode = 1 };
+enum { wayland_wl_subcompositor_get_subsurface_size = 20 };
+static inline void wayland_wl_subcompositor_get_subsurface_encode(uint32_t *msg, uint32_t self, uint32_t arg_id, uint32_t arg_surface, uint32_t arg_parent) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_subcompositor_get_subsurface_size << 16 | wayland_wl_subcompositor_get_subsurface_opcode;
+  msg[2] = (uint32_t)arg_id;
+  msg[3] = (uint32_t)arg_surface;
+  msg[4] = (uint32_t)arg_parent;
+}
+
+// wl_subsurface.destroy
+enum { wayland_wl_subsurface_destroy_opcode = 0 };
+enum { wayland_wl_subsurface_destroy_size = 8 };
+static inline void wayland_wl_subsurface_destroy_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_subsurface_destroy_size << 16 | wayland_wl_subsurface_destroy_opcode;
+}
+
+// wl_subsurface.set_position
+enum { wayland_wl_subsurface_set_position_opcode = 1 };
+enum { wayland_wl_subsurface_set_position_size = 16 };
+static inline void wayland_wl_subsurface_set_position_encode(uint32_t *msg, uint32_t self, int32_t arg_x, int32_t arg_y) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_subsurface_set_position_size << 16 | wayland_wl_subsurface_set_position_opcode;
+  msg[2] = (uint32_t)arg_x;
+  msg[3] = (uint32_t)arg_y;
+}
+
+// wl_subsurface.place_above
+enum { wayland_wl_subsurface_place_above_opcode = 2 };
+enum { wayland_wl_subsurface_place_above_size = 12 };
+static inline void wayland_wl_subsurface_place_above_encode(uint32_t *msg, uint32_t self, uint32_t arg_sibling) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_subsurface_place_above_size << 16 | wayland_wl_subsurface_place_above_opcode;
+  msg[2] = (uint32_t)arg_sibling;
+}
+
+// wl_subsurface.place_below
+enum { wayland_wl_subsurface_place_below_opcode = 3 };
+enum { wayland_wl_subsurface_place_below_size = 12 };
+static inline void wayland_wl_subsurface_place_below_encode(uint32_t *msg, uint32_t self, uint32_t arg_sibling) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_subsurface_place_below_size << 16 | wayland_wl_subsurface_place_below_opcode;
+  msg[2] = (uint32_t)arg_sibling;
+}
+
+// wl_subsurface.set_sync
+enum { wayland_wl_subsurface_set_sync_opcode = 4 };
+enum { wayland_wl_subsurface_set_sync_size = 8 };
+static inline void wayland_wl_subsurface_set_sync_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_subsurface_set_sync_size << 16 | wayland_wl_subsurface_set_sync_opcode;
+}
+
+// wl_subsurface.set_desync
+enum { wayland_wl_subsurface_set_desync_opcode = 5 };
+enum { wayland_wl_subsurface_set_desync_size = 8 };
+static inline void wayland_wl_subsurface_set_desync_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_wl_subsurface_set_desync_size << 16 | wayland_wl_subsurface_set_desync_opcode;
+}
+
+// xdg_wm_base.destroy
+enum { wayland_xdg_wm_base_destroy_opcode = 0 };
+enum { wayland_xdg_wm_base_destroy_size = 8 };
+static inline void wayland_xdg_wm_base_destroy_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_wm_base_destroy_size << 16 | wayland_xdg_wm_base_destroy_opcode;
+}
+
+// xdg_wm_base.create_positioner
+enum { wayland_xdg_wm_base_create_positioner_opcode = 1 };
+enum { wayland_xdg_wm_base_create_positioner_size = 12 };
+static inline void wayland_xdg_wm_base_create_positioner_encode(uint32_t *msg, uint32_t self, uint32_t arg_id) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_wm_base_create_positioner_size << 16 | wayland_xdg_wm_base_create_positioner_opcode;
+  msg[2] = (uint32_t)arg_id;
+}
+
+// xdg_wm_base.get_xdg_surface
+enum { wayland_xdg_wm_base_get_xdg_surface_opcode = 2 };
+enum { wayland_xdg_wm_base_get_xdg_surface_size = 16 };
+static inline void wayland_xdg_wm_base_get_xdg_surface_encode(uint32_t *msg, uint32_t self, uint32_t arg_id, uint32_t arg_surface) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_wm_base_get_xdg_surface_size << 16 | wayland_xdg_wm_base_get_xdg_surface_opcode;
+  msg[2] = (uint32_t)arg_id;
+  msg[3] = (uint32_t)arg_surface;
+}
+
+// xdg_wm_base.pong
+enum { wayland_xdg_wm_base_pong_opcode = 3 };
+enum { wayland_xdg_wm_base_pong_size = 12 };
+static inline void wayland_xdg_wm_base_pong_encode(uint32_t *msg, uint32_t self, uint32_t arg_serial) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_wm_base_pong_size << 16 | wayland_xdg_wm_base_pong_opcode;
+  msg[2] = (uint32_t)arg_serial;
+}
+
+// xdg_wm_base.ping
+enum { wayland_xdg_wm_base_ping_opcode = 0 };
+typedef struct wayland_xdg_wm_base_ping_event_t wayland_xdg_wm_base_ping_event_t;
+struct wayland_xdg_wm_base_ping_event_t {
+  uint32_t serial;
+};
+static inline int wayland_xdg_wm_base_ping_decode(const uint32_t *body, uint64_t body_len, wayland_xdg_wm_base_ping_event_t *event) {
+  if (body_len != 4)
+    return 0;
+  const uint32_t *r = body;
+  event->serial = *r++;
+  (void)r;
+  return 1;
+}
+
+// xdg_wm_base events: file descriptors received along.
+static inline uint32_t wayland_xdg_wm_base_event_fds(uint16_t opcode) {
+  (void)opcode;
+  return 0;
+}
+
+// xdg_positioner.destroy
+enum { wayland_xdg_positioner_destroy_opcode = 0 };
+enum { wayland_xdg_positioner_destroy_size = 8 };
+static inline void wayland_xdg_positioner_destroy_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_positioner_destroy_size << 16 | wayland_xdg_positioner_destroy_opcode;
+}
+
+// xdg_positioner.set_size
+enum { wayland_xdg_positioner_set_size_opcode = 1 };
+enum { wayland_xdg_positioner_set_size_size = 16 };
+static inline void wayland_xdg_positioner_set_size_encode(uint32_t *msg, uint32_t self, int32_t arg_width, int32_t arg_height) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_positioner_set_size_size << 16 | wayland_xdg_positioner_set_size_opcode;
+  msg[2] = (uint32_t)arg_width;
+  msg[3] = (uint32_t)arg_height;
+}
+
+// xdg_positioner.set_anchor_rect
+enum { wayland_xdg_positioner_set_anchor_rect_opcode = 2 };
+enum { wayland_xdg_positioner_set_anchor_rect_size = 24 };
+static inline void wayland_xdg_positioner_set_anchor_rect_encode(uint32_t *msg, uint32_t self, int32_t arg_x, int32_t arg_y, int32_t arg_width, int32_t arg_height) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_positioner_set_anchor_rect_size << 16 | wayland_xdg_positioner_set_anchor_rect_opcode;
+  msg[2] = (uint32_t)arg_x;
+  msg[3] = (uint32_t)arg_y;
+  msg[4] = (uint32_t)arg_width;
+  msg[5] = (uint32_t)arg_height;
+}
+
+// xdg_positioner.set_anchor
+enum { wayland_xdg_positioner_set_anchor_opcode = 3 };
+enum { wayland_xdg_positioner_set_anchor_size = 12 };
+static inline void wayland_xdg_positioner_set_anchor_encode(uint32_t *msg, uint32_t self, uint32_t arg_anchor) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_positioner_set_anchor_size << 16 | wayland_xdg_positioner_set_anchor_opcode;
+  msg[2] = (uint32_t)arg_anchor;
+}
+
+// xdg_positioner.set_gravity
+enum { wayland_xdg_positioner_set_gravity_opcode = 4 };
+enum { wayland_xdg_positioner_set_gravity_size = 12 };
+static inline void wayland_xdg_positioner_set_gravity_encode(uint32_t *msg, uint32_t self, uint32_t arg_gravity) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_positioner_set_gravity_size << 16 | wayland_xdg_positioner_set_gravity_opcode;
+  msg[2] = (uint32_t)arg_gravity;
+}
+
+// xdg_positioner.set_constraint_adjustment
+enum { wayland_xdg_positioner_set_constraint_adjustment_opcode = 5 };
+enum { wayland_xdg_positioner_set_constraint_adjustment_size = 12 };
+static inline void wayland_xdg_positioner_set_constraint_adjustment_encode(uint32_t *msg, uint32_t self, uint32_t arg_constraint_adjustment) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_positioner_set_constraint_adjustment_size << 16 | wayland_xdg_positioner_set_constraint_adjustment_opcode;
+  msg[2] = (uint32_t)arg_constraint_adjustment;
+}
+
+// xdg_positioner.set_offset
+enum { wayland_xdg_positioner_set_offset_opcode = 6 };
+enum { wayland_xdg_positioner_set_offset_size = 16 };
+static inline void wayland_xdg_positioner_set_offset_encode(uint32_t *msg, uint32_t self, int32_t arg_x, int32_t arg_y) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_positioner_set_offset_size << 16 | wayland_xdg_positioner_set_offset_opcode;
+  msg[2] = (uint32_t)arg_x;
+  msg[3] = (uint32_t)arg_y;
+}
+
+// xdg_positioner.set_reactive
+enum { wayland_xdg_positioner_set_reactive_opcode = 7 };
+enum { wayland_xdg_positioner_set_reactive_size = 8 };
+static inline void wayland_xdg_positioner_set_reactive_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_positioner_set_reactive_size << 16 | wayland_xdg_positioner_set_reactive_opcode;
+}
+
+// xdg_positioner.set_parent_size
+enum { wayland_xdg_positioner_set_parent_size_opcode = 8 };
+enum { wayland_xdg_positioner_set_parent_size_size = 16 };
+static inline void wayland_xdg_positioner_set_parent_size_encode(uint32_t *msg, uint32_t self, int32_t arg_parent_width, int32_t arg_parent_height) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_positioner_set_parent_size_size << 16 | wayland_xdg_positioner_set_parent_size_opcode;
+  msg[2] = (uint32_t)arg_parent_width;
+  msg[3] = (uint32_t)arg_parent_height;
+}
+
+// xdg_positioner.set_parent_configure
+enum { wayland_xdg_positioner_set_parent_configure_opcode = 9 };
+enum { wayland_xdg_positioner_set_parent_configure_size = 12 };
+static inline void wayland_xdg_positioner_set_parent_configure_encode(uint32_t *msg, uint32_t self, uint32_t arg_serial) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_positioner_set_parent_configure_size << 16 | wayland_xdg_positioner_set_parent_configure_opcode;
+  msg[2] = (uint32_t)arg_serial;
+}
+
+// xdg_surface.destroy
+enum { wayland_xdg_surface_destroy_opcode = 0 };
+enum { wayland_xdg_surface_destroy_size = 8 };
+static inline void wayland_xdg_surface_destroy_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_surface_destroy_size << 16 | wayland_xdg_surface_destroy_opcode;
+}
+
+// xdg_surface.get_toplevel
+enum { wayland_xdg_surface_get_toplevel_opcode = 1 };
+enum { wayland_xdg_surface_get_toplevel_size = 12 };
+static inline void wayland_xdg_surface_get_toplevel_encode(uint32_t *msg, uint32_t self, uint32_t arg_id) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_surface_get_toplevel_size << 16 | wayland_xdg_surface_get_toplevel_opcode;
+  msg[2] = (uint32_t)arg_id;
+}
+
+// xdg_surface.get_popup
+enum { wayland_xdg_surface_get_popup_opcode = 2 };
+enum { wayland_xdg_surface_get_popup_size = 20 };
+static inline void wayland_xdg_surface_get_popup_encode(uint32_t *msg, uint32_t self, uint32_t arg_id, uint32_t arg_parent, uint32_t arg_positioner) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_surface_get_popup_size << 16 | wayland_xdg_surface_get_popup_opcode;
+  msg[2] = (uint32_t)arg_id;
+  msg[3] = (uint32_t)arg_parent;
+  msg[4] = (uint32_t)arg_positioner;
+}
+
+// xdg_surface.set_window_geometry
+enum { wayland_xdg_surface_set_window_geometry_opcode = 3 };
+enum { wayland_xdg_surface_set_window_geometry_size = 24 };
+static inline void wayland_xdg_surface_set_window_geometry_encode(uint32_t *msg, uint32_t self, int32_t arg_x, int32_t arg_y, int32_t arg_width, int32_t arg_height) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_surface_set_window_geometry_size << 16 | wayland_xdg_surface_set_window_geometry_opcode;
+  msg[2] = (uint32_t)arg_x;
+  msg[3] = (uint32_t)arg_y;
+  msg[4] = (uint32_t)arg_width;
+  msg[5] = (uint32_t)arg_height;
+}
+
+// xdg_surface.ack_configure
+enum { wayland_xdg_surface_ack_configure_opcode = 4 };
+enum { wayland_xdg_surface_ack_configure_size = 12 };
+static inline void wayland_xdg_surface_ack_configure_encode(uint32_t *msg, uint32_t self, uint32_t arg_serial) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_surface_ack_configure_size << 16 | wayland_xdg_surface_ack_configure_opcode;
+  msg[2] = (uint32_t)arg_serial;
+}
+
+// xdg_surface.configure
+enum { wayland_xdg_surface_configure_opcode = 0 };
+typedef struct wayland_xdg_surface_configure_event_t wayland_xdg_surface_configure_event_t;
+struct wayland_xdg_surface_configure_event_t {
+  uint32_t serial;
+};
+static inline int wayland_xdg_surface_configure_decode(const uint32_t *body, uint64_t body_len, wayland_xdg_surface_configure_event_t *event) {
+  if (body_len != 4)
+    return 0;
+  const uint32_t *r = body;
+  event->serial = *r++;
+  (void)r;
+  return 1;
+}
+
+// xdg_surface events: file descriptors received along.
+static inline uint32_t wayland_xdg_surface_event_fds(uint16_t opcode) {
+  (void)opcode;
+  return 0;
+}
+
+// xdg_toplevel.destroy
+enum { wayland_xdg_toplevel_destroy_opcode = 0 };
+enum { wayland_xdg_toplevel_destroy_size = 8 };
+static inline void wayland_xdg_toplevel_destroy_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_toplevel_destroy_size << 16 | wayland_xdg_toplevel_destroy_opcode;
+}
+
+// xdg_toplevel.set_parent
+enum { wayland_xdg_toplevel_set_parent_opcode = 1 };
+enum { wayland_xdg_toplevel_set_parent_size = 12 };
+static inline void wayland_xdg_toplevel_set_parent_encode(uint32_t *msg, uint32_t self, uint32_t arg_parent) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_toplevel_set_parent_size << 16 | wayland_xdg_toplevel_set_parent_opcode;
+  msg[2] = (uint32_t)arg_parent;
+}
+
+// xdg_toplevel.set_title
+enum { wayland_xdg_toplevel_set_title_opcode = 2 };
+static inline uint16_t wayland_xdg_toplevel_set_title_size(uint32_t arg_title_len) {
+  return 12 + ((arg_title_len + 3) & -4);
+}
+static inline void wayland_xdg_toplevel_set_title_encode(uint32_t *msg, uint32_t self, const char *arg_title, uint32_t arg_title_len) {
+  msg[0] = self;
+  uint16_t size = wayland_xdg_toplevel_set_title_size(arg_title_len);
+  msg[1] = (uint32_t)size << 16 | wayland_xdg_toplevel_set_title_opcode;
+  uint32_t *w = msg + 2;
+  *w++ = arg_title_len;
+  memcpy(w, arg_title, arg_title_len);
+  memset((char *)w + arg_title_len, 0, ((arg_title_len + 3) & -4) - arg_title_len);
+  w += (arg_title_len + 3) / 4;
+  (void)w;
+}
+
+// xdg_toplevel.set_app_id
+enum { wayland_xdg_toplevel_set_app_id_opcode = 3 };
+static inline uint16_t wayland_xdg_toplevel_set_app_id_size(uint32_t arg_app_id_len) {
+  return 12 + ((arg_app_id_len + 3) & -4);
+}
+static inline void wayland_xdg_toplevel_set_app_id_encode(uint32_t *msg, uint32_t self, const char *arg_app_id, uint32_t arg_app_id_len) {
+  msg[0] = self;
+  uint16_t size = wayland_xdg_toplevel_set_app_id_size(arg_app_id_len);
+  msg[1] = (uint32_t)size << 16 | wayland_xdg_toplevel_set_app_id_opcode;
+  uint32_t *w = msg + 2;
+  *w++ = arg_app_id_len;
+  memcpy(w, arg_app_id, arg_app_id_len);
+  memset((char *)w + arg_app_id_len, 0, ((arg_app_id_len + 3) & -4) - arg_app_id_len);
+  w += (arg_app_id_len + 3) / 4;
+  (void)w;
+}
+
+// xdg_toplevel.show_window_menu
+enum { wayland_xdg_toplevel_show_window_menu_opcode = 4 };
+enum { wayland_xdg_toplevel_show_window_menu_size = 24 };
+static inline void wayland_xdg_toplevel_show_window_menu_encode(uint32_t *msg, uint32_t self, uint32_t arg_seat, uint32_t arg_serial, int32_t arg_x, int32_t arg_y) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_toplevel_show_window_menu_size << 16 | wayland_xdg_toplevel_show_window_menu_opcode;
+  msg[2] = (uint32_t)arg_seat;
+  msg[3] = (uint32_t)arg_serial;
+  msg[4] = (uint32_t)arg_x;
+  msg[5] = (uint32_t)arg_y;
+}
+
+// xdg_toplevel.move
+enum { wayland_xdg_toplevel_move_opcode = 5 };
+enum { wayland_xdg_toplevel_move_size = 16 };
+static inline void wayland_xdg_toplevel_move_encode(uint32_t *msg, uint32_t self, uint32_t arg_seat, uint32_t arg_serial) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_toplevel_move_size << 16 | wayland_xdg_toplevel_move_opcode;
+  msg[2] = (uint32_t)arg_seat;
+  msg[3] = (uint32_t)arg_serial;
+}
+
+// xdg_toplevel.resize
+enum { wayland_xdg_toplevel_resize_opcode = 6 };
+enum { wayland_xdg_toplevel_resize_size = 20 };
+static inline void wayland_xdg_toplevel_resize_encode(uint32_t *msg, uint32_t self, uint32_t arg_seat, uint32_t arg_serial, uint32_t arg_edges) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_toplevel_resize_size << 16 | wayland_xdg_toplevel_resize_opcode;
+  msg[2] = (uint32_t)arg_seat;
+  msg[3] = (uint32_t)arg_serial;
+  msg[4] = (uint32_t)arg_edges;
+}
+
+// xdg_toplevel.set_max_size
+enum { wayland_xdg_toplevel_set_max_size_opcode = 7 };
+enum { wayland_xdg_toplevel_set_max_size_size = 16 };
+static inline void wayland_xdg_toplevel_set_max_size_encode(uint32_t *msg, uint32_t self, int32_t arg_width, int32_t arg_height) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_toplevel_set_max_size_size << 16 | wayland_xdg_toplevel_set_max_size_opcode;
+  msg[2] = (uint32_t)arg_width;
+  msg[3] = (uint32_t)arg_height;
+}
+
+// xdg_toplevel.set_min_size
+enum { wayland_xdg_toplevel_set_min_size_opcode = 8 };
+enum { wayland_xdg_toplevel_set_min_size_size = 16 };
+static inline void wayland_xdg_toplevel_set_min_size_encode(uint32_t *msg, uint32_t self, int32_t arg_width, int32_t arg_height) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_toplevel_set_min_size_size << 16 | wayland_xdg_toplevel_set_min_size_opcode;
+  msg[2] = (uint32_t)arg_width;
+  msg[3] = (uint32_t)arg_height;
+}
+
+// xdg_toplevel.set_maximized
+enum { wayland_xdg_toplevel_set_maximized_opcode = 9 };
+enum { wayland_xdg_toplevel_set_maximized_size = 8 };
+static inline void wayland_xdg_toplevel_set_maximized_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_toplevel_set_maximized_size << 16 | wayland_xdg_toplevel_set_maximized_opcode;
+}
+
+// xdg_toplevel.unset_maximized
+enum { wayland_xdg_toplevel_unset_maximized_opcode = 10 };
+enum { wayland_xdg_toplevel_unset_maximized_size = 8 };
+static inline void wayland_xdg_toplevel_unset_maximized_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_toplevel_unset_maximized_size << 16 | wayland_xdg_toplevel_unset_maximized_opcode;
+}
+
+// xdg_toplevel.set_fullscreen
+enum { wayland_xdg_toplevel_set_fullscreen_opcode = 11 };
+enum { wayland_xdg_toplevel_set_fullscreen_size = 12 };
+static inline void wayland_xdg_toplevel_set_fullscreen_encode(uint32_t *msg, uint32_t self, uint32_t arg_output) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_toplevel_set_fullscreen_size << 16 | wayland_xdg_toplevel_set_fullscreen_opcode;
+  msg[2] = (uint32_t)arg_output;
+}
+
+// xdg_toplevel.unset_fullscreen
+enum { wayland_xdg_toplevel_unset_fullscreen_opcode = 12 };
+enum { wayland_xdg_toplevel_unset_fullscreen_size = 8 };
+static inline void wayland_xdg_toplevel_unset_fullscreen_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_toplevel_unset_fullscreen_size << 16 | wayland_xdg_toplevel_unset_fullscreen_opcode;
+}
+
+// xdg_toplevel.set_minimized
+enum { wayland_xdg_toplevel_set_minimized_opcode = 13 };
+enum { wayland_xdg_toplevel_set_minimized_size = 8 };
+static inline void wayland_xdg_toplevel_set_minimized_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_toplevel_set_minimized_size << 16 | wayland_xdg_toplevel_set_minimized_opcode;
+}
+
+// xdg_toplevel.configure
+enum { wayland_xdg_toplevel_configure_opcode = 0 };
+typedef struct wayland_xdg_toplevel_configure_event_t wayland_xdg_toplevel_configure_event_t;
+struct wayland_xdg_toplevel_configure_event_t {
+  int32_t width;
+  int32_t height;
+  const void *states;
+  uint32_t states_len;
+};
+static inline int wayland_xdg_toplevel_configure_decode(const uint32_t *body, uint64_t body_len, wayland_xdg_toplevel_configure_event_t *event) {
+  if (body_len % 4 != 0 || body_len < 12)
+    return 0;
+  const uint32_t *end = body + body_len / 4;
+  const uint32_t *r = body;
+  event->width = (int32_t)*r++;
+  event->height = (int32_t)*r++;
+  event->states_len = *r++;
+  if ((uint64_t)(end - r) * 4 < event->states_len)
+    return 0;
+  event->states = (const void *)r;
+  r += (event->states_len + 3) / 4;
+  return r == end;
+}
+
+// xdg_toplevel.close
+enum { wayland_xdg_toplevel_close_opcode = 1 };
+
+// xdg_toplevel.configure_bounds
+enum { wayland_xdg_toplevel_configure_bounds_opcode = 2 };
+typedef struct wayland_xdg_toplevel_configure_bounds_event_t wayland_xdg_toplevel_configure_bounds_event_t;
+struct wayland_xdg_toplevel_configure_bounds_event_t {
+  int32_t width;
+  int32_t height;
+};
+static inline int wayland_xdg_toplevel_configure_bounds_decode(const uint32_t *body, uint64_t body_len, wayland_xdg_toplevel_configure_bounds_event_t *event) {
+  if (body_len != 8)
+    return 0;
+  const uint32_t *r = body;
+  event->width = (int32_t)*r++;
+  event->height = (int32_t)*r++;
+  (void)r;
+  return 1;
+}
+
+// xdg_toplevel.wm_capabilities
+enum { wayland_xdg_toplevel_wm_capabilities_opcode = 3 };
+typedef struct wayland_xdg_toplevel_wm_capabilities_event_t wayland_xdg_toplevel_wm_capabilities_event_t;
+struct wayland_xdg_toplevel_wm_capabilities_event_t {
+  const void *capabilities;
+  uint32_t capabilities_len;
+};
+static inline int wayland_xdg_toplevel_wm_capabilities_decode(const uint32_t *body, uint64_t body_len, wayland_xdg_toplevel_wm_capabilities_event_t *event) {
+  if (body_len % 4 != 0 || body_len < 4)
+    return 0;
+  const uint32_t *end = body + body_len / 4;
+  const uint32_t *r = body;
+  event->capabilities_len = *r++;
+  if ((uint64_t)(end - r) * 4 < event->capabilities_len)
+    return 0;
+  event->capabilities = (const void *)r;
+  r += (event->capabilities_len + 3) / 4;
+  return r == end;
+}
+
+// xdg_toplevel events: file descriptors received along.
+static inline uint32_t wayland_xdg_toplevel_event_fds(uint16_t opcode) {
+  (void)opcode;
+  return 0;
+}
+
+// xdg_popup.destroy
+enum { wayland_xdg_popup_destroy_opcode = 0 };
+enum { wayland_xdg_popup_destroy_size = 8 };
+static inline void wayland_xdg_popup_destroy_encode(uint32_t *msg, uint32_t self) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_popup_destroy_size << 16 | wayland_xdg_popup_destroy_opcode;
+}
+
+// xdg_popup.grab
+enum { wayland_xdg_popup_grab_opcode = 1 };
+enum { wayland_xdg_popup_grab_size = 16 };
+static inline void wayland_xdg_popup_grab_encode(uint32_t *msg, uint32_t self, uint32_t arg_seat, uint32_t arg_serial) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_popup_grab_size << 16 | wayland_xdg_popup_grab_opcode;
+  msg[2] = (uint32_t)arg_seat;
+  msg[3] = (uint32_t)arg_serial;
+}
+
+// xdg_popup.reposition
+enum { wayland_xdg_popup_reposition_opcode = 2 };
+enum { wayland_xdg_popup_reposition_size = 16 };
+static inline void wayland_xdg_popup_reposition_encode(uint32_t *msg, uint32_t self, uint32_t arg_positioner, uint32_t arg_token) {
+  msg[0] = self;
+  msg[1] = (uint32_t)wayland_xdg_popup_reposition_size << 16 | wayland_xdg_popup_reposition_opcode;
+  msg[2] = (uint32_t)arg_positioner;
+  msg[3] = (uint32_t)arg_token;
+}
+
+// xdg_popup.configure
+enum { wayland_xdg_popup_configure_opcode = 0 };
+typedef struct wayland_xdg_popup_configure_event_t wayland_xdg_popup_configure_event_t;
+struct wayland_xdg_popup_configure_event_t {
+  int32_t x;
+  int32_t y;
+  int32_t width;
+  int32_t height;
+};
+static inline int wayland_xdg_popup_configure_decode(const uint32_t *body, uint64_t body_len, wayland_xdg_popup_configure_event_t *event) {
+  if (body_len != 16)
+    return 0;
+  const uint32_t *r = body;
+  event->x = (int32_t)*r++;
+  event->y = (int32_t)*r++;
+  event->width = (int32_t)*r++;
+  event->height = (int32_t)*r++;
+  (void)r;
+  return 1;
+}
+
+// xdg_popup.popup_done
+enum { wayland_xdg_popup_popup_done_opcode = 1 };
+
+// xdg_popup.repositioned
+enum { wayland_xdg_popup_repositioned_opcode = 2 };
+typedef struct wayland_xdg_popup_repositioned_event_t wayland_xdg_popup_repositioned_event_t;
+struct wayland_xdg_popup_repositioned_event_t {
+  uint32_t token;
+};
+static inline int wayland_xdg_popup_repositioned_decode(const uint32_t *body, uint64_t body_len, wayland_xdg_popup_repositioned_event_t *event) {
+  if (body_len != 4)
+    return 0;
+  const uint32_t *r = body;
+  event->token = *r++;
+  (void)r;
+  return 1;
+}
+
+// xdg_popup events: file descriptors received along.
+static inline uint32_t wayland_xdg_popup_event_fds(uint16_t opcode) {
+  (void)opcode;
+  return 0;
+}
@@ -0,0 +1,79 @@
+// Decode a protocol trace written by a debug build of the client (run with
+// `WAYLAND_TRACE_PATH=wayland.trace`) into text, one line per record, with
+// the time in microseconds since the first record.
+//
+// Build and run with:
+//
+//   cc -std=c99 wayland-trace-decode.c -o wayland-trace-decode
+//   ./wayland-trace-decode wayland.trace
+#include <assert.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "wayland-trace.h"
+
+static void read_exact(FILE *file, void *dst, uint64_t size) {
+  if (fread(dst, 1, size, file) != size) {
+    fprintf(stderr, "truncated trace\n");
+    exit(1);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  if (argc != 2) {
+    fprintf(stderr, "Usage: %s wayland.trace\n", argv[0]);
+    return 1;
+  }
+
+  FILE *file = fopen(argv[1], "rb");
+  if (file == NULL) {
+    perror(argv[1]);
+    return 1;
+  }
+
+  char magic[sizeof(trace_file_magic)] = {0};
+  read_exact(file, magic, sizeof(magic));
+  if (memcmp(magic, trace_file_magic, sizeof(magic)) != 0) {
+    fprintf(stderr, "%s: not a trace\n", argv[1]);
+    return 1;
+  }
+
+  uint32_t fmts_len = 0, records_len = 0;
+  read_exact(file, &fmts_len, sizeof(fmts_len));
+  read_exact(file, &records_len, sizeof(records_len));
+
+  char **fmts = calloc(fmts_len, sizeof(char *));
+  assert(fmts != NULL || fmts_len == 0);
+  for (uint32_t i = 0; i < fmts_len; i++) {
+    uint32_t len = 0;
+    read_exact(file, &len, sizeof(len));
+    fmts[i] = calloc(len + 1, 1);
+    assert(fmts[i] != NULL);
+    read_exact(file, fmts[i], len);
+  }
+
+  uint64_t start_ns = 0;
+  for (uint32_t i = 0; i < records_len; i++) {
+    trace_record_t record = {0};
+    read_exact(file, &record, sizeof(record));
+    if (record.fmt_index >= fmts_len || record.args_len > trace_args_max) {
+      fprintf(stderr, "corrupt record %u\n", i);
+      return 1;
+    }
+    record.str[trace_str_max - 1] = 0;
+
+    if (i == 0)
+      start_ns = record.ns;
+    printf("%10.3f ", (double)(record.ns - start_ns) / 1000);
+    if (!trace_record_print(stdout, fmts[record.fmt_index], &record)) {
+      fflush(stdout);
+      fprintf(stderr, "\ncorrupt format in record %u\n", i);
+      return 1;
+    }
+  }
+
+  return 0;
+}
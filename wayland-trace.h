@@ -0,0 +1,71 @@
+// Binary protocol trace, recorded by the client in debug builds (see `trace`
+// in `wayland.c`) and decoded offline by `wayland-trace-decode`.
+//
+// File layout, in native byte order:
+// - `trace_file_magic`.
+// - `uint32_t` count of format strings, `uint32_t` count of records.
+// - Each format string: `uint32_t` length, then the bytes (no terminator).
+// - Each record: a `trace_record_t`, `fmt_index` set.
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define trace_args_max 6
+#define trace_str_max 32
+
+static const char trace_file_magic[8] = "WLTRACE1";
+
+typedef struct trace_record_t trace_record_t;
+struct trace_record_t {
+  uint64_t ns;
+  // A string literal from a `trace` call site. Meaningless in a file, where
+  // `fmt_index` is used instead.
+  const char *fmt;
+  uint64_t fmt_index;
+  uint32_t args[trace_args_max];
+  uint32_t args_len;
+  // Value of the `%s` conversion, if any, truncated.
+  char str[trace_str_max];
+};
+
+// Format the record like `printf` would have. Integer conversions take the
+// arguments in order, and `%s` takes `str`. The format may come from a trace
+// file: only flags, a width and a precision are copied into the `fprintf`
+// spec, and anything else (e.g. `*`, a length modifier, `%n`) rejects the
+// record. Returns false then, with the output stopped short.
+static inline bool trace_record_print(FILE *out, const char *fmt,
+                                      const trace_record_t *record) {
+  uint32_t arg = 0;
+  for (const char *c = fmt; *c != 0; c++) {
+    if (*c != '%') {
+      fputc(*c, out);
+      continue;
+    }
+
+    char spec[16] = "%";
+    uint32_t spec_len = 1;
+    c++;
+    while (*c != 0 && strchr("sdiuxXc%", *c) == NULL) {
+      if (strchr("-+ #0123456789.", *c) == NULL ||
+          spec_len + 2 >= sizeof(spec))
+        return false;
+      spec[spec_len++] = *c++;
+    }
+    if (*c == 0)
+      return false;
+
+    if (*c == '%') {
+      fputc('%', out);
+    } else if (*c == 's') {
+      fputs(record->str, out);
+    } else {
+      spec[spec_len++] = *c;
+      spec[spec_len] = 0;
+      fprintf(out, spec, arg < record->args_len ? record->args[arg] : 0);
+      arg++;
+    }
+  }
+
+  return true;
+}
@@ -0,0 +1,3463 @@
+#define _POSIX_C_SOURCE 200112L
+#if defined(__linux__)
+// For `memfd_create` and file sealing.
+#define _GNU_SOURCE
+#endif
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+// Link with `-pthread` on libcs older than glibc 2.34.
+#include <pthread.h>
+#include <signal.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define WAYLAND_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+#if defined(WAYLAND_LOGO_XRGB)
+// Generated by `wayland-logo-gen xrgb`.
+#include "wayland-logo-xrgb.h"
+#elif defined(WAYLAND_LOGO_RLE)
+// Generated by `wayland-logo-gen rle`.
+#include "wayland-logo-rle.h"
+#elif defined(WAYLAND_LOGO_EMBED)
+// Embed the raw pixels (generated by `wayland-logo-gen rgb`) without going
+// through a giant C array literal that the compiler has to tokenize on every
+// build. `#embed` looks the file up like `#include`: next to this source file
+// first. `.incbin` looks it up in the assembler's working directory, then in
+// the `-I` paths (forwarded by the compiler driver): when building from
+// another directory, pass `-I` with the one holding `wayland-logo.rgb`.
+#if defined(__has_embed)
+__attribute__((aligned(64))) static const unsigned char wayland_logo[] = {
+#embed "wayland-logo.rgb"
+};
+static const unsigned int wayland_logo_len = sizeof(wayland_logo);
+#else
+__asm__(".section .rodata\n"
+        ".balign 64\n"
+        ".global wayland_logo\n"
+        ".hidden wayland_logo\n"
+        ".type wayland_logo, @object\n"
+        "wayland_logo:\n"
+        ".incbin \"wayland-logo.rgb\"\n"
+        ".global wayland_logo_end\n"
+        ".hidden wayland_logo_end\n"
+        "wayland_logo_end:\n"
+        ".size wayland_logo, wayland_logo_end - wayland_logo\n"
+        ".previous\n");
+extern const unsigned char wayland_logo[]
+    __attribute__((visibility("hidden")));
+extern const unsigned char wayland_logo_end[]
+    __attribute__((visibility("hidden")));
+#define wayland_logo_len ((uint64_t)(wayland_logo_end - wayland_logo))
+#endif
+#else
+#include "wayland-logo.h"
+#endif
+
+#define cstring_len(s) (sizeof(s) - 1)
+
+#define roundup_4(n) (((n) + 3) & -4)
+
+#define array_len(a) (sizeof(a) / sizeof((a)[0]))
+
+// Generated by `wayland-protocol-gen` from `wayland.xml` and `xdg-shell.xml`.
+#include "wayland-protocol.h"
+
+static uint64_t clock_now_ns() {
+  struct timespec ts = {0};
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) == -1)
+    exit(errno);
+  return (uint64_t)ts.tv_sec * 1000 * 1000 * 1000 + (uint64_t)ts.tv_nsec;
+}
+
+// Protocol tracing: `trace("-> wl_surface@%u.commit\n", id)`, with `uint32_t`
+// arguments, and `trace_str` for (at most) one `%s` argument.
+// - Release builds (`NDEBUG`): compiled out, arguments not evaluated.
+// - Debug builds: a binary record (no formatting, no lock) goes into a ring
+//   keeping the latest ones, dumped at exit to `WAYLAND_TRACE_PATH` if set,
+//   for `wayland-trace-decode`.
+// - With `WAYLAND_TRACE_STDOUT` too: also printed right away, as text.
+#if defined(NDEBUG)
+// Type-checks the arguments, and keeps the variables only traced used.
+#define trace_str(fmt, str, str_len, ...)                                      \
+  do {                                                                         \
+    if (0) {                                                                   \
+      const uint32_t trace_args[] = {__VA_ARGS__};                             \
+      (void)trace_args;                                                        \
+      (void)(str);                                                             \
+      (void)(str_len);                                                         \
+    }                                                                          \
+  } while (0)
+#else
+#include "wayland-trace.h"
+
+// Written by any thread, read at exit.
+static struct {
+  trace_record_t records[4096];
+  uint64_t len;
+} trace_ring;
+
+static void trace_push(const char *fmt, const char *str, uint32_t str_len,
+                       const uint32_t *args, uint32_t args_len) {
+  assert(args_len <= trace_args_max);
+
+  // Each writer owns its slot: wrapping around overwrites the oldest record.
+  uint64_t i = __atomic_fetch_add(&trace_ring.len, 1, __ATOMIC_RELAXED);
+  trace_record_t *record =
+      &trace_ring.records[i % array_len(trace_ring.records)];
+  record->ns = clock_now_ns();
+  record->fmt = fmt;
+  memcpy(record->args, args, args_len * sizeof(*args));
+  record->args_len = args_len;
+
+  if (str_len >= trace_str_max)
+    str_len = trace_str_max - 1;
+  memcpy(record->str, str, str_len);
+  record->str[str_len] = 0;
+
+#if defined(WAYLAND_TRACE_STDOUT)
+  trace_record_print(stdout, fmt, record);
+#endif
+}
+
+#define trace_str(fmt, str, str_len, ...)                                      \
+  do {                                                                         \
+    const uint32_t trace_args[] = {__VA_ARGS__};                               \
+    trace_push((fmt), (str), (str_len), trace_args, array_len(trace_args));    \
+  } while (0)
+
+// Format strings are deduplicated by address: each call site has its own
+// literal.
+static void trace_dump() {
+  const char *path = getenv("WAYLAND_TRACE_PATH");
+  if (path == NULL)
+    return;
+
+  FILE *file = fopen(path, "wb");
+  if (file == NULL) {
+    perror(path);
+    return;
+  }
+
+  uint64_t cap = array_len(trace_ring.records);
+  uint64_t end = __atomic_load_n(&trace_ring.len, __ATOMIC_ACQUIRE);
+  uint64_t begin = end > cap ? end - cap : 0;
+
+  static const char *fmts[256];
+  uint32_t fmts_len = 0;
+  for (uint64_t i = begin; i < end; i++) {
+    trace_record_t *record = &trace_ring.records[i % cap];
+    uint32_t j = 0;
+    while (j < fmts_len && fmts[j] != record->fmt)
+      j++;
+    if (j == fmts_len) {
+      assert(fmts_len < array_len(fmts));
+      fmts[fmts_len++] = record->fmt;
+    }
+    record->fmt_index = j;
+  }
+
+  uint32_t records_len = (uint32_t)(end - begin);
+  fwrite(trace_file_magic, sizeof(trace_file_magic), 1, file);
+  fwrite(&fmts_len, sizeof(fmts_len), 1, file);
+  fwrite(&records_len, sizeof(records_len), 1, file);
+  for (uint32_t j = 0; j < fmts_len; j++) {
+    uint32_t len = strlen(fmts[j]);
+    fwrite(&len, sizeof(len), 1, file);
+    fwrite(fmts[j], 1, len, file);
+  }
+  for (uint64_t i = begin; i < end; i++)
+    fwrite(&trace_ring.records[i % cap], sizeof(trace_record_t), 1, file);
+
+  fclose(file);
+}
+#endif
+
+#define trace(fmt, ...) trace_str((fmt), "", 0, __VA_ARGS__)
+
+static const uint32_t wayland_display_object_id = 1;
+// The latest versions whose events we all know of: bound at a newer one, an
+// interface could send opcodes we cannot tell from garbage.
+static const uint32_t wayland_wl_compositor_version_max = 6;
+static const uint32_t wayland_wl_shm_version_max = 2;
+static const uint32_t wayland_xdg_wm_base_version_max = 6;
+static const uint32_t wayland_wl_surface_damage_buffer_since = 4;
+static const uint32_t wayland_format_xrgb8888 = 1;
+// Enough for every event we handle: pointer frames and axis sources, keyboard
+// repeat info.
+static const uint32_t wayland_wl_seat_version_max = 5;
+static const uint32_t wayland_wl_seat_release_since = 3;
+static const uint32_t wayland_seat_capability_pointer = 1;
+static const uint32_t wayland_seat_capability_keyboard = 2;
+static const uint32_t wayland_pointer_axis_horizontal = 1;
+static const uint32_t wayland_keymap_format_xkb_v1 = 1;
+// XKB keycodes are evdev codes shifted by 8.
+static const uint32_t keymap_evdev_offset = 8;
+// The Shift real modifier, always the first one.
+static const uint32_t keymap_shift_mask = 1;
+static const uint32_t wayland_header_size = 8;
+static const uint32_t color_channels = 4;
+static const uint32_t logo_w = 117;
+static const uint32_t logo_h = 150;
+// Keeps the pool well within the `int32_t` size of `wl_shm_pool`.
+static const uint32_t surface_size_max = 8192;
+// Activity bar along the bottom edge, when animating.
+static const uint32_t animation_bar_h = 4;
+static const uint32_t animation_bar_bg = 0xffffffff;
+static const uint32_t animation_bar_fg = 0xff404040;
+
+typedef enum state_state_t state_state_t;
+enum state_state_t {
+  STATE_NONE,
+  STATE_SURFACE_ACKED_CONFIGURE,
+  STATE_SURFACE_ATTACHED,
+};
+
+typedef struct rect_t rect_t;
+struct rect_t {
+  uint32_t x;
+  uint32_t y;
+  uint32_t w;
+  uint32_t h;
+};
+
+typedef struct damage_t damage_t;
+struct damage_t {
+  rect_t rects[16];
+  uint32_t len;
+};
+
+typedef struct buffer_t buffer_t;
+struct buffer_t {
+  uint32_t wl_buffer;
+  // Region in the shm pool, reused as long as frames fit in it.
+  uint32_t offset;
+  uint32_t capacity;
+  // Attached and not released yet by the compositor: we must not touch it.
+  uint8_t busy;
+  // Size of `wl_buffer` and of the frame it holds, 0 if there is none yet.
+  uint32_t content_w;
+  uint32_t content_h;
+  // Animation tick of the frame it holds.
+  uint64_t content_tick;
+};
+
+typedef struct frame_stats_t frame_stats_t;
+struct frame_stats_t {
+  // Latency from a frame callback to the commit of the next frame. Bucket `i`
+  // counts latencies in [2^i, 2^(i+1)) microseconds, bucket 0 also counts 0.
+  uint64_t latency_buckets[32];
+  uint64_t latency_us_sum;
+  uint64_t latency_us_max;
+  uint64_t frames;
+  // When the last frame callback fired, 0 if we already committed since.
+  uint64_t done_ns;
+};
+
+// Same limit as libwayland for one `sendmsg`, well under the kernel's
+// `SCM_MAX_FD`.
+#define connection_fds_max 28
+
+typedef struct connection_t connection_t;
+typedef struct state_t state_t;
+
+// Handles one event, `body` pointing right after the header and `body_len`
+// bytes long.
+typedef void (*wayland_event_handler_t)(connection_t *conn, state_t *state,
+                                        uint32_t object_id,
+                                        const uint32_t *body,
+                                        uint64_t body_len);
+
+// The interfaces we know of, to index the metrics.
+typedef enum interface_index_t interface_index_t;
+enum interface_index_t {
+  INTERFACE_WL_DISPLAY,
+  INTERFACE_WL_REGISTRY,
+  INTERFACE_WL_COMPOSITOR,
+  INTERFACE_WL_SURFACE,
+  INTERFACE_WL_CALLBACK,
+  INTERFACE_WL_SHM,
+  INTERFACE_WL_SHM_POOL,
+  INTERFACE_WL_BUFFER,
+  INTERFACE_XDG_WM_BASE,
+  INTERFACE_XDG_SURFACE,
+  INTERFACE_XDG_TOPLEVEL,
+  INTERFACE_WL_SEAT,
+  INTERFACE_WL_POINTER,
+  INTERFACE_WL_KEYBOARD,
+  INTERFACE_LEN,
+};
+
+typedef struct wayland_interface_t wayland_interface_t;
+struct wayland_interface_t {
+  const char *name;
+  interface_index_t index;
+  // Indexed by event opcode: every event up to the version we bind, NULL for
+  // those we have no use for.
+  const wayland_event_handler_t *events;
+  uint16_t events_len;
+  // Generated: file descriptors an event carries, for skipped ones to close.
+  uint32_t (*event_fds)(uint16_t opcode);
+};
+
+// Opcodes past the last one are counted with it.
+#define metrics_opcodes_max 16
+
+typedef struct metrics_messages_t metrics_messages_t;
+struct metrics_messages_t {
+  uint64_t count;
+  uint64_t bytes;
+};
+
+// Counters of a connection since it was opened. Plain data: a snapshot is a
+// copy.
+typedef struct metrics_t metrics_t;
+struct metrics_t {
+  // Indexed by interface, then opcode.
+  metrics_messages_t requests[INTERFACE_LEN][metrics_opcodes_max];
+  metrics_messages_t events[INTERFACE_LEN][metrics_opcodes_max];
+  uint64_t requests_total;
+  uint64_t events_total;
+  uint64_t sendmsg_calls;
+  uint64_t sendmsg_bytes;
+  uint64_t recvmsg_calls;
+  uint64_t recvmsg_bytes;
+  uint64_t fds_sent;
+  uint64_t fds_received;
+  // From reading an `xdg_wm_base.ping` off the socket to sending the pong.
+  uint64_t pongs;
+  uint64_t pong_latency_ns_sum;
+  uint64_t pong_latency_ns_max;
+};
+
+struct connection_t {
+  int fd;
+  // Outgoing requests, sent together by `connection_flush`.
+  char out[4096] __attribute__((aligned(4)));
+  uint64_t out_len;
+  metrics_t metrics;
+  // When the last read happened, and when the ping we are answering was read
+  // (0 if none).
+  uint64_t read_ns;
+  uint64_t pong_pending_ns;
+  // File descriptors to send as ancillary data with the next flush, in the
+  // order of the requests referencing them.
+  int fds_out[connection_fds_max];
+  uint32_t fds_out_len;
+  // Received file descriptors not yet taken by an event handler, in order.
+  int fds_in[connection_fds_max];
+  uint32_t fds_in_len;
+  // Incoming bytes. Complete messages are handled in place, and an incomplete
+  // trailing message is moved to the front, to be completed by the next read.
+  char *in;
+  uint64_t in_len;
+  uint64_t in_cap;
+  // The last read filled the buffer: more is probably waiting.
+  uint8_t in_burst;
+  // Interface of each live object, indexed by object id, for the dispatch.
+  const wayland_interface_t **objects;
+  uint32_t objects_cap;
+  // Highest id handed out so far.
+  uint32_t ids_max;
+  // Ids released by `wl_display.delete_id`, reused last in first out: ids stay
+  // dense, and so does `objects`.
+  uint32_t *ids_free;
+  uint32_t ids_free_len;
+  uint32_t ids_free_cap;
+};
+
+// Pointer and keyboard events, decoded straight from the receive buffer by the
+// handlers and consumed once per loop iteration: no allocation nor formatting
+// per event, however fast the mouse reports.
+typedef enum input_event_type_t input_event_type_t;
+enum input_event_type_t {
+  INPUT_POINTER_ENTER,
+  INPUT_POINTER_LEAVE,
+  INPUT_POINTER_MOTION,
+  INPUT_POINTER_BUTTON,
+  INPUT_POINTER_AXIS,
+  INPUT_KEYBOARD_ENTER,
+  INPUT_KEYBOARD_LEAVE,
+  INPUT_KEY,
+  INPUT_MODIFIERS,
+};
+
+typedef struct input_event_t input_event_t;
+struct input_event_t {
+  input_event_type_t type;
+  uint32_t time_ms;
+  // 24.8 fixed point: the pointer position in surface coordinates, or the
+  // scroll amount for an axis event.
+  int32_t x, y;
+  // The button or key (evdev code), or the depressed and latched modifiers.
+  uint32_t code;
+  // 1 when pressed, 0 when released, or the locked modifiers.
+  uint32_t pressed;
+  // For a key, from the keymap: 0 (`NoSymbol`) without one.
+  uint32_t keysym;
+};
+
+#define input_ring_len 256
+
+typedef struct input_ring_t input_ring_t;
+struct input_ring_t {
+  input_event_t events[input_ring_len];
+  // Free running: `head - tail` events are pending.
+  uint64_t head;
+  uint64_t tail;
+  uint64_t motions_merged;
+};
+
+#define keymap_keycodes_len 256
+#define keymap_levels 2
+
+// What we keep of the XKB keymap: for the first group, the keysym of each key
+// without and with Shift. Translating a key is one load.
+typedef struct keymap_t keymap_t;
+struct keymap_t {
+  // Indexed by XKB keycode, then level.
+  uint32_t keysyms[keymap_keycodes_len][keymap_levels];
+};
+
+// Renders the logo at its own size on another thread, while the first round
+// trips are in flight, and signals `wakeup_fd` when done.
+typedef struct prerender_t prerender_t;
+struct prerender_t {
+  pthread_t thread;
+  // Started and not joined yet: the buffers and the pool are off limits.
+  int running;
+  uint32_t *pixels;
+  // Only the logo source and `wakeup_fd` are read from it.
+  const state_t *state;
+};
+
+struct state_t {
+  uint32_t wl_registry;
+  // From `wl_display.sync`, right after `wl_display.get_registry`.
+  uint32_t wl_callback_registry_done;
+  uint32_t wl_shm;
+  uint32_t wl_shm_pool;
+  // Triple buffering, all carved from the same shm pool: while the
+  // compositor reads from one buffer, we can render into another one.
+  buffer_t buffers[3];
+  // The buffer last attached to the surface, if any.
+  buffer_t *front;
+  // Pending frame callback: do not render until the compositor is ready.
+  uint32_t wl_callback;
+  frame_stats_t frame_stats;
+  uint32_t xdg_wm_base;
+  uint32_t xdg_surface;
+  uint32_t wl_compositor;
+  uint32_t wl_compositor_version;
+  uint32_t wl_surface;
+  uint32_t xdg_toplevel;
+  uint32_t stride;
+  uint32_t w;
+  uint32_t h;
+  // Size from the last `xdg_toplevel.configure`, applied when acking the
+  // `xdg_surface.configure` that follows. 0 lets us pick.
+  uint32_t configure_w;
+  uint32_t configure_h;
+  uint32_t shm_pool_size;
+  // The pool size is a multiple of it.
+  uint64_t shm_page_size;
+  int shm_fd;
+  uint8_t *shm_pool_data;
+  // Optional: the pre-converted logo mapped from a file.
+  const uint32_t *logo_xrgb;
+  uint64_t logo_xrgb_size;
+  // Optional: animation ticks per second, 0 for a still frame.
+  uint32_t animation_hz;
+  uint64_t ticks;
+  // Written to by other threads to wake the event loop up.
+  int wakeup_fd;
+  prerender_t prerender;
+  uint32_t wl_seat;
+  uint32_t wl_seat_version;
+  uint32_t wl_pointer;
+  uint32_t wl_keyboard;
+  input_ring_t input;
+  keymap_t keymap;
+  // Level of the keysyms of the next key events: 1 while Shift is held.
+  uint32_t keyboard_level;
+  // Last position, 24.8 fixed point, while the pointer is over the surface.
+  int32_t pointer_x, pointer_y;
+  int pointer_focus;
+
+  state_state_t state;
+};
+
+// Defined with their event handlers, further down.
+static const wayland_interface_t wayland_wl_display_interface;
+static const wayland_interface_t wayland_wl_registry_interface;
+static const wayland_interface_t wayland_wl_compositor_interface;
+static const wayland_interface_t wayland_wl_surface_interface;
+static const wayland_interface_t wayland_wl_callback_interface;
+static const wayland_interface_t wayland_wl_shm_interface;
+static const wayland_interface_t wayland_wl_shm_pool_interface;
+static const wayland_interface_t wayland_wl_buffer_interface;
+static const wayland_interface_t wayland_xdg_wm_base_interface;
+static const wayland_interface_t wayland_xdg_surface_interface;
+static const wayland_interface_t wayland_xdg_toplevel_interface;
+static const wayland_interface_t wayland_wl_seat_interface;
+static const wayland_interface_t wayland_wl_pointer_interface;
+static const wayland_interface_t wayland_wl_keyboard_interface;
+
+static const wayland_interface_t *const wayland_interfaces[INTERFACE_LEN] = {
+    [INTERFACE_WL_DISPLAY] = &wayland_wl_display_interface,
+    [INTERFACE_WL_REGISTRY] = &wayland_wl_registry_interface,
+    [INTERFACE_WL_COMPOSITOR] = &wayland_wl_compositor_interface,
+    [INTERFACE_WL_SURFACE] = &wayland_wl_surface_interface,
+    [INTERFACE_WL_CALLBACK] = &wayland_wl_callback_interface,
+    [INTERFACE_WL_SHM] = &wayland_wl_shm_interface,
+    [INTERFACE_WL_SHM_POOL] = &wayland_wl_shm_pool_interface,
+    [INTERFACE_WL_BUFFER] = &wayland_wl_buffer_interface,
+    [INTERFACE_XDG_WM_BASE] = &wayland_xdg_wm_base_interface,
+    [INTERFACE_XDG_SURFACE] = &wayland_xdg_surface_interface,
+    [INTERFACE_XDG_TOPLEVEL] = &wayland_xdg_toplevel_interface,
+    [INTERFACE_WL_SEAT] = &wayland_wl_seat_interface,
+    [INTERFACE_WL_POINTER] = &wayland_wl_pointer_interface,
+    [INTERFACE_WL_KEYBOARD] = &wayland_wl_keyboard_interface,
+};
+
+// Text dump, on `SIGUSR1` and at exit. Only what happened is listed.
+static void metrics_print(FILE *out, const metrics_t *metrics) {
+  fprintf(out,
+          "requests: %" PRIu64 ", events: %" PRIu64 "\n"
+          "sendmsg: %" PRIu64 " calls, %" PRIu64 " bytes, %" PRIu64 " fds\n"
+          "recvmsg: %" PRIu64 " calls, %" PRIu64 " bytes, %" PRIu64 " fds\n",
+          metrics->requests_total, metrics->events_total,
+          metrics->sendmsg_calls, metrics->sendmsg_bytes, metrics->fds_sent,
+          metrics->recvmsg_calls, metrics->recvmsg_bytes,
+          metrics->fds_received);
+
+  if (metrics->pongs > 0)
+    fprintf(out, "ping->pong: %" PRIu64 ", avg %.1fus, max %.1fus\n",
+            metrics->pongs,
+            (double)metrics->pong_latency_ns_sum / metrics->pongs / 1000,
+            (double)metrics->pong_latency_ns_max / 1000);
+
+  for (uint32_t i = 0; i < INTERFACE_LEN; i++) {
+    for (uint32_t opcode = 0; opcode < metrics_opcodes_max; opcode++) {
+      const metrics_messages_t *requests = &metrics->requests[i][opcode];
+      if (requests->count > 0)
+        fprintf(out,
+                "  -> %s#%u: %" PRIu64 " messages, %" PRIu64 " bytes\n",
+                wayland_interfaces[i]->name, opcode, requests->count,
+                requests->bytes);
+
+      const metrics_messages_t *events = &metrics->events[i][opcode];
+      if (events->count > 0)
+        fprintf(out,
+                "  <- %s#%u: %" PRIu64 " messages, %" PRIu64 " bytes\n",
+                wayland_interfaces[i]->name, opcode, events->count,
+                events->bytes);
+    }
+  }
+}
+
+static int wayland_display_connect() {
+  char *xdg_runtime_dir = getenv("XDG_RUNTIME_DIR");
+  if (xdg_runtime_dir == NULL)
+    return EINVAL;
+
+  uint64_t xdg_runtime_dir_len = strlen(xdg_runtime_dir);
+
+  struct sockaddr_un addr = {.sun_family = AF_UNIX};
+  assert(xdg_runtime_dir_len <= cstring_len(addr.sun_path));
+  uint64_t socket_path_len = 0;
+
+  memcpy(addr.sun_path, xdg_runtime_dir, xdg_runtime_dir_len);
+  socket_path_len += xdg_runtime_dir_len;
+
+  addr.sun_path[socket_path_len++] = '/';
+
+  char *wayland_display = getenv("WAYLAND_DISPLAY");
+  if (wayland_display == NULL) {
+    char wayland_display_default[] = "wayland-0";
+    uint64_t wayland_display_default_len = cstring_len(wayland_display_default);
+
+    memcpy(addr.sun_path + socket_path_len, wayland_display_default,
+           wayland_display_default_len);
+    socket_path_len += wayland_display_default_len;
+  } else {
+    uint64_t wayland_display_len = strlen(wayland_display);
+    memcpy(addr.sun_path + socket_path_len, wayland_display,
+           wayland_display_len);
+    socket_path_len += wayland_display_len;
+  }
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd == -1)
+    exit(errno);
+
+  if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == -1)
+    exit(errno);
+
+  return fd;
+}
+
+static void metrics_count(metrics_messages_t *messages, uint16_t opcode,
+                          uint64_t bytes) {
+  if (opcode >= metrics_opcodes_max)
+    opcode = metrics_opcodes_max - 1;
+  messages[opcode].count++;
+  messages[opcode].bytes += bytes;
+}
+
+// Send the queued requests, and all the queued file descriptors along with
+// the first bytes, in one `sendmsg`.
+static void connection_flush(connection_t *conn) {
+  // One pass over the headers, rather than counting in `connection_reserve`
+  // before the requests are encoded.
+  for (uint64_t offset = 0; offset < conn->out_len;) {
+    const uint32_t *header = (const uint32_t *)(conn->out + offset);
+    uint16_t size = header[1] >> 16;
+    const wayland_interface_t *interface = conn->objects[header[0]];
+    assert(interface != NULL);
+    assert(size >= wayland_header_size);
+
+    metrics_count(conn->metrics.requests[interface->index],
+                  header[1] & 0xffff, size);
+    conn->metrics.requests_total++;
+    offset += size;
+  }
+  // File descriptors ride along with bytes: a `sendmsg` of 0 bytes on a
+  // stream socket sends nothing, and they would be lost. Without a request,
+  // they stay queued.
+  assert(conn->out_len > 0 || conn->fds_out_len == 0);
+  if (conn->out_len > 0)
+    conn->metrics.fds_sent += conn->fds_out_len;
+
+  uint64_t written = 0;
+  while (written < conn->out_len) {
+    // UNIX/Macros monstrosities ahead.
+    union {
+      char buf[CMSG_SPACE(sizeof(conn->fds_out))];
+      struct cmsghdr align;
+    } control;
+    memset(&control, 0, sizeof(control));
+
+    struct iovec io = {
+        .iov_base = conn->out + written,
+        .iov_len = conn->out_len - written,
+    };
+    struct msghdr socket_msg = {.msg_iov = &io, .msg_iovlen = 1};
+
+    if (conn->fds_out_len > 0) {
+      uint64_t fds_size = conn->fds_out_len * sizeof(int);
+      socket_msg.msg_control = control.buf;
+      socket_msg.msg_controllen = CMSG_SPACE(fds_size);
+
+      struct cmsghdr *cmsg = CMSG_FIRSTHDR(&socket_msg);
+      cmsg->cmsg_level = SOL_SOCKET;
+      cmsg->cmsg_type = SCM_RIGHTS;
+      cmsg->cmsg_len = CMSG_LEN(fds_size);
+      memcpy(CMSG_DATA(cmsg), conn->fds_out, fds_size);
+    }
+
+    int64_t n = sendmsg(conn->fd, &socket_msg, 0);
+    if (n == -1)
+      exit(errno);
+
+    // The file descriptors went out with the first byte.
+    conn->fds_out_len = 0;
+    written += (uint64_t)n;
+    conn->metrics.sendmsg_calls++;
+    conn->metrics.sendmsg_bytes += (uint64_t)n;
+  }
+  conn->out_len = 0;
+
+  if (conn->pong_pending_ns != 0) {
+    uint64_t latency_ns = clock_now_ns() - conn->pong_pending_ns;
+    conn->pong_pending_ns = 0;
+
+    conn->metrics.pongs++;
+    conn->metrics.pong_latency_ns_sum += latency_ns;
+    if (latency_ns > conn->metrics.pong_latency_ns_max)
+      conn->metrics.pong_latency_ns_max = latency_ns;
+  }
+}
+
+// Queue a file descriptor, to be sent with the next flush. It must be queued
+// before the request referencing it, so that it never arrives after it. The
+// caller keeps ownership: the compositor gets a duplicate.
+static void connection_push_fd(connection_t *conn, int fd) {
+  assert(fd >= 0);
+  if (conn->fds_out_len == connection_fds_max) {
+    // Only a request can carry the queued ones out.
+    if (conn->out_len == 0) {
+      fprintf(stderr, "too many file descriptors queued without a request: "
+                      "%u\n",
+              conn->fds_out_len);
+      exit(EOVERFLOW);
+    }
+    connection_flush(conn);
+  }
+
+  conn->fds_out[conn->fds_out_len++] = fd;
+}
+
+// Take the oldest received file descriptor, for an event with an `fd`
+// argument. The caller owns it.
+static int connection_pop_fd(connection_t *conn) {
+  if (conn->fds_in_len == 0) {
+    fprintf(stderr, "missing file descriptor for an event\n");
+    exit(EPROTO);
+  }
+
+  int fd = conn->fds_in[0];
+  conn->fds_in_len--;
+  memmove(conn->fds_in, conn->fds_in + 1, conn->fds_in_len * sizeof(int));
+
+  return fd;
+}
+
+// Reserve room for a request in the queue, for it to be encoded in place and
+// sent along with the others in one syscall.
+static uint32_t *connection_reserve(connection_t *conn, uint64_t msg_size) {
+  assert(msg_size <= sizeof(conn->out));
+  assert(roundup_4(msg_size) == msg_size);
+  if (conn->out_len + msg_size > sizeof(conn->out))
+    connection_flush(conn);
+
+  uint32_t *msg = (uint32_t *)(conn->out + conn->out_len);
+  conn->out_len += msg_size;
+
+  return msg;
+}
+
+static const uint64_t connection_in_cap_min = 4096;
+static const uint64_t connection_in_cap_max = 1024 * 1024;
+
+// Read as much as available (blocking if nothing is). The buffer grows when
+// an incomplete message takes up half of it, or during bursts, so that large
+// bursts take fewer syscalls.
+static void connection_read(connection_t *conn) {
+  uint64_t cap = conn->in_cap < connection_in_cap_min ? connection_in_cap_min
+                                                      : conn->in_cap;
+  if (conn->in_len > cap / 2 ||
+      (conn->in_burst && cap * 2 <= connection_in_cap_max))
+    cap *= 2;
+
+  if (cap != conn->in_cap) {
+    char *in = realloc(conn->in, cap);
+    if (in == NULL)
+      exit(ENOMEM);
+    conn->in = in;
+    conn->in_cap = cap;
+  }
+
+  union {
+    char buf[CMSG_SPACE(sizeof(conn->fds_in))];
+    struct cmsghdr align;
+  } control;
+
+  uint64_t space = conn->in_cap - conn->in_len;
+  struct iovec io = {.iov_base = conn->in + conn->in_len, .iov_len = space};
+  struct msghdr socket_msg = {
+      .msg_iov = &io,
+      .msg_iovlen = 1,
+      .msg_control = control.buf,
+      .msg_controllen = sizeof(control.buf),
+  };
+
+  // Received file descriptors are not inherited by children we may spawn.
+  int64_t read_bytes = recvmsg(conn->fd, &socket_msg, MSG_CMSG_CLOEXEC);
+  if (read_bytes == -1)
+    exit(errno);
+  if (socket_msg.msg_flags & MSG_CTRUNC) {
+    fprintf(stderr, "too many file descriptors from the compositor\n");
+    exit(EMSGSIZE);
+  }
+
+  // The kernel may merge the file descriptors of several `sendmsg` into one
+  // read, in one or several headers.
+  for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&socket_msg); cmsg != NULL;
+       cmsg = CMSG_NXTHDR(&socket_msg, cmsg)) {
+    if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+      continue;
+
+    uint64_t fds_size = cmsg->cmsg_len - CMSG_LEN(0);
+    uint32_t fds_len = fds_size / sizeof(int);
+    // Not taken by the events read so far: the compositor sent more than
+    // its messages reference.
+    if (conn->fds_in_len + fds_len > connection_fds_max) {
+      fprintf(stderr, "too many pending file descriptors from the "
+                      "compositor\n");
+      exit(EPROTO);
+    }
+    memcpy(conn->fds_in + conn->fds_in_len, CMSG_DATA(cmsg), fds_size);
+    conn->fds_in_len += fds_len;
+    conn->metrics.fds_received += fds_len;
+  }
+  if (read_bytes == 0) {
+    fprintf(stderr, "the compositor closed the connection\n");
+    exit(EPIPE);
+  }
+
+  conn->in_len += (uint64_t)read_bytes;
+  conn->in_burst = (uint64_t)read_bytes == space;
+  conn->read_ns = clock_now_ns();
+  conn->metrics.recvmsg_calls++;
+  conn->metrics.recvmsg_bytes += (uint64_t)read_bytes;
+}
+
+static void connection_set_object(connection_t *conn, uint32_t id,
+                                  const wayland_interface_t *interface) {
+  if (id >= conn->objects_cap) {
+    uint32_t cap = conn->objects_cap < 64 ? 64 : conn->objects_cap;
+    while (cap <= id)
+      cap *= 2;
+
+    const wayland_interface_t **objects =
+        realloc(conn->objects, cap * sizeof(*conn->objects));
+    if (objects == NULL)
+      exit(ENOMEM);
+    memset(objects + conn->objects_cap, 0,
+           (cap - conn->objects_cap) * sizeof(*objects));
+    conn->objects = objects;
+    conn->objects_cap = cap;
+  }
+
+  conn->objects[id] = interface;
+}
+
+static uint32_t connection_new_id(connection_t *conn,
+                                  const wayland_interface_t *interface) {
+  uint32_t id = conn->ids_free_len > 0 ? conn->ids_free[--conn->ids_free_len]
+                                       : ++conn->ids_max;
+  connection_set_object(conn, id, interface);
+  return id;
+}
+
+// Only once the compositor has acknowledged the destruction: until then, it
+// may still send events to the id.
+static void connection_free_id(connection_t *conn, uint32_t id) {
+  const char *reason = NULL;
+  if (id == wayland_display_object_id)
+    reason = "the display";
+  else if (id > conn->ids_max)
+    reason = "never allocated";
+  else if (conn->objects[id] == NULL)
+    reason = "already freed";
+
+  if (reason != NULL) {
+    fprintf(stderr, "invalid delete_id: id=%u: %s\n", id, reason);
+    exit(EPROTO);
+  }
+
+  connection_set_object(conn, id, NULL);
+
+  if (conn->ids_free_len == conn->ids_free_cap) {
+    uint32_t cap = conn->ids_free_cap < 16 ? 16 : conn->ids_free_cap * 2;
+    uint32_t *ids_free = realloc(conn->ids_free, cap * sizeof(*ids_free));
+    if (ids_free == NULL)
+      exit(ENOMEM);
+    conn->ids_free = ids_free;
+    conn->ids_free_cap = cap;
+  }
+  conn->ids_free[conn->ids_free_len++] = id;
+}
+
+// The compositor answers in order: the callback is done once every global has
+// been announced.
+static uint32_t wayland_wl_display_sync(connection_t *conn) {
+  uint32_t id = connection_new_id(conn, &wayland_wl_callback_interface);
+  wayland_wl_display_sync_encode(
+      connection_reserve(conn, wayland_wl_display_sync_size),
+      wayland_display_object_id, id);
+
+  trace("-> wl_display@%u.sync: wl_callback=%u\n", wayland_display_object_id,
+        id);
+
+  return id;
+}
+
+static uint32_t wayland_wl_display_get_registry(connection_t *conn) {
+  uint32_t id = connection_new_id(conn, &wayland_wl_registry_interface);
+  wayland_wl_display_get_registry_encode(
+      connection_reserve(conn, wayland_wl_display_get_registry_size),
+      wayland_display_object_id, id);
+
+  trace("-> wl_display@%u.get_registry: wl_registry=%u\n",
+        wayland_display_object_id, id);
+
+  return id;
+}
+
+static uint32_t wayland_wl_registry_bind(connection_t *conn, uint32_t registry,
+                                         uint32_t name,
+                                         const wayland_interface_t *interface,
+                                         uint32_t version) {
+  // The length includes the NULL terminator.
+  uint32_t interface_len = strlen(interface->name) + 1;
+
+  uint32_t id = connection_new_id(conn, interface);
+  wayland_wl_registry_bind_encode(
+      connection_reserve(conn, wayland_wl_registry_bind_size(interface_len)),
+      registry, name, interface->name, interface_len, version, id);
+
+  trace_str("-> wl_registry@%u.bind: name=%u interface=%s version=%u\n",
+            interface->name, interface_len - 1, registry, name, version);
+
+  return id;
+}
+
+static uint32_t wayland_wl_compositor_create_surface(connection_t *conn,
+                                                     state_t *state) {
+  assert(state->wl_compositor > 0);
+
+  uint32_t id = connection_new_id(conn, &wayland_wl_surface_interface);
+  wayland_wl_compositor_create_surface_encode(
+      connection_reserve(conn, wayland_wl_compositor_create_surface_size),
+      state->wl_compositor, id);
+
+  trace("-> wl_compositor@%u.create_surface: wl_surface=%u\n",
+        state->wl_compositor, id);
+
+  return id;
+}
+
+// Fallback for systems without `memfd_create`: a named shared memory object,
+// unlinked right away.
+static int shm_file_open(uint64_t size) {
+  char name[255] = "/";
+  for (uint64_t i = 1; i < cstring_len(name); i++) {
+    name[i] = ((double)rand()) / (double)RAND_MAX * 26 + 'a';
+  }
+
+  int fd = shm_open(name, O_RDWR | O_EXCL | O_CREAT, 0600);
+  if (fd == -1)
+    exit(errno);
+
+  if (shm_unlink(name) == -1)
+    exit(errno);
+
+  if (ftruncate(fd, size) == -1)
+    exit(errno);
+
+  return fd;
+}
+
+#if defined(MFD_ALLOW_SEALING)
+// Anonymous file, no name to make up nor to unlink. Sealed against shrinking,
+// so that the compositor never gets `SIGBUS` from us truncating it under its
+// mapping. Returns -1 when not supported.
+static int shm_file_memfd(uint64_t size) {
+  int fd = memfd_create("wayland-shm", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+  if (fd == -1)
+    return -1;
+
+  if (ftruncate(fd, size) == -1 ||
+      fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_SEAL) == -1) {
+    close(fd);
+    return -1;
+  }
+
+  return fd;
+}
+#endif
+
+static void create_shared_memory_file(uint64_t size, state_t *state) {
+  // Sent as an int32 in `wl_shm.create_pool`.
+  if (size > INT32_MAX) {
+    fprintf(stderr, "shm pool too large: %" PRIu64 " bytes\n", size);
+    exit(EOVERFLOW);
+  }
+
+  int fd = -1;
+  state->shm_page_size = (uint64_t)sysconf(_SC_PAGESIZE);
+
+#if defined(MFD_ALLOW_SEALING)
+  fd = shm_file_memfd(size);
+#endif
+
+  if (fd == -1)
+    fd = shm_file_open(size);
+
+  void *data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED)
+    exit(errno);
+
+  state->shm_pool_data = data;
+  state->shm_pool_size = size;
+  state->shm_fd = fd;
+}
+
+// Grow the file and its mapping, keeping the contents (and the wl_buffers
+// already carved): no new fd, no new pool. `mremap` moves the mapping if it
+// cannot grow in place, so pointers into the pool must not be kept around.
+static void shm_pool_grow(uint64_t size, state_t *state) {
+  assert(size > state->shm_pool_size);
+  size = (size + state->shm_page_size - 1) / state->shm_page_size *
+         state->shm_page_size;
+  // Sent as an int32 in `wl_shm_pool.resize`.
+  if (size > INT32_MAX) {
+    fprintf(stderr, "shm pool too large: %" PRIu64 " bytes\n", size);
+    exit(EOVERFLOW);
+  }
+
+  if (ftruncate(state->shm_fd, size) == -1)
+    exit(errno);
+
+  void *data = MAP_FAILED;
+#if defined(MREMAP_MAYMOVE)
+  data = mremap(state->shm_pool_data, state->shm_pool_size, size,
+                MREMAP_MAYMOVE);
+#endif
+  if (data == MAP_FAILED) {
+    munmap(state->shm_pool_data, state->shm_pool_size);
+    data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, state->shm_fd,
+                0);
+  }
+  if (data == MAP_FAILED)
+    exit(errno);
+
+  state->shm_pool_data = data;
+  state->shm_pool_size = size;
+}
+
+// Map a pre-converted logo file (see `wayland-logo-gen xrgb-raw`) read-only
+// and shared: all the clients on the host then use the same page cache pages
+// instead of each having its own copy.
+static void logo_xrgb_map(const char *path, state_t *state) {
+  int fd = open(path, O_RDONLY);
+  if (fd == -1)
+    exit(errno);
+
+  struct stat st = {0};
+  if (fstat(fd, &st) == -1)
+    exit(errno);
+
+  uint64_t size = state->w * state->h * sizeof(uint32_t);
+  if ((uint64_t)st.st_size != size) {
+    fprintf(stderr, "logo file %s: expected %" PRIu64 " bytes, got %" PRIu64
+                    "\n",
+            path, size, (uint64_t)st.st_size);
+    exit(EINVAL);
+  }
+
+  void *data = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED)
+    exit(errno);
+  close(fd);
+
+  state->logo_xrgb = data;
+  state->logo_xrgb_size = size;
+}
+
+static void wayland_xdg_wm_base_pong(connection_t *conn, state_t *state,
+                                     uint32_t ping) {
+  assert(state->xdg_wm_base > 0);
+  assert(state->wl_surface > 0);
+
+  wayland_xdg_wm_base_pong_encode(
+      connection_reserve(conn, wayland_xdg_wm_base_pong_size),
+      state->xdg_wm_base, ping);
+
+  trace("-> xdg_wm_base@%u.pong: ping=%u\n", state->xdg_wm_base, ping);
+}
+
+static void wayland_xdg_surface_ack_configure(connection_t *conn,
+                                              state_t *state,
+                                              uint32_t configure) {
+  assert(state->xdg_surface > 0);
+
+  wayland_xdg_surface_ack_configure_encode(
+      connection_reserve(conn, wayland_xdg_surface_ack_configure_size),
+      state->xdg_surface, configure);
+
+  trace("-> xdg_surface@%u.ack_configure: configure=%u\n", state->xdg_surface,
+        configure);
+}
+
+static uint32_t wayland_wl_seat_get_pointer(connection_t *conn,
+                                            state_t *state) {
+  assert(state->wl_seat > 0);
+
+  uint32_t id = connection_new_id(conn, &wayland_wl_pointer_interface);
+  wayland_wl_seat_get_pointer_encode(
+      connection_reserve(conn, wayland_wl_seat_get_pointer_size),
+      state->wl_seat, id);
+
+  trace("-> wl_seat@%u.get_pointer: wl_pointer=%u\n", state->wl_seat, id);
+
+  return id;
+}
+
+static uint32_t wayland_wl_seat_get_keyboard(connection_t *conn,
+                                             state_t *state) {
+  assert(state->wl_seat > 0);
+
+  uint32_t id = connection_new_id(conn, &wayland_wl_keyboard_interface);
+  wayland_wl_seat_get_keyboard_encode(
+      connection_reserve(conn, wayland_wl_seat_get_keyboard_size),
+      state->wl_seat, id);
+
+  trace("-> wl_seat@%u.get_keyboard: wl_keyboard=%u\n", state->wl_seat, id);
+
+  return id;
+}
+
+static void wayland_wl_pointer_release(connection_t *conn, state_t *state) {
+  assert(state->wl_pointer > 0);
+
+  wayland_wl_pointer_release_encode(
+      connection_reserve(conn, wayland_wl_pointer_release_size),
+      state->wl_pointer);
+
+  trace("-> wl_pointer@%u.release\n", state->wl_pointer);
+}
+
+static void wayland_wl_keyboard_release(connection_t *conn, state_t *state) {
+  assert(state->wl_keyboard > 0);
+
+  wayland_wl_keyboard_release_encode(
+      connection_reserve(conn, wayland_wl_keyboard_release_size),
+      state->wl_keyboard);
+
+  trace("-> wl_keyboard@%u.release\n", state->wl_keyboard);
+}
+
+static uint32_t wayland_wl_shm_create_pool(connection_t *conn, state_t *state) {
+  assert(state->shm_pool_size > 0);
+
+  connection_push_fd(conn, state->shm_fd);
+
+  uint32_t id = connection_new_id(conn, &wayland_wl_shm_pool_interface);
+  wayland_wl_shm_create_pool_encode(
+      connection_reserve(conn, wayland_wl_shm_create_pool_size), state->wl_shm,
+      id, state->shm_pool_size);
+
+  trace("-> wl_shm@%u.create_pool: wl_shm_pool=%u\n", state->wl_shm, id);
+
+  return id;
+}
+
+static uint32_t wayland_xdg_wm_base_get_xdg_surface(connection_t *conn,
+                                                    state_t *state) {
+  assert(state->xdg_wm_base > 0);
+  assert(state->wl_surface > 0);
+
+  uint32_t id = connection_new_id(conn, &wayland_xdg_surface_interface);
+  wayland_xdg_wm_base_get_xdg_surface_encode(
+      connection_reserve(conn, wayland_xdg_wm_base_get_xdg_surface_size),
+      state->xdg_wm_base, id, state->wl_surface);
+
+  trace("-> xdg_wm_base@%u.get_xdg_surface: xdg_surface=%u wl_surface=%u\n",
+        state->xdg_wm_base, id, state->wl_surface);
+
+  return id;
+}
+
+static uint32_t wayland_wl_shm_pool_create_buffer(connection_t *conn,
+                                                  state_t *state,
+                                                  uint32_t offset) {
+  assert(state->wl_shm_pool > 0);
+
+  uint32_t id = connection_new_id(conn, &wayland_wl_buffer_interface);
+  wayland_wl_shm_pool_create_buffer_encode(
+      connection_reserve(conn, wayland_wl_shm_pool_create_buffer_size),
+      state->wl_shm_pool, id, offset, state->w, state->h, state->stride,
+      wayland_format_xrgb8888);
+
+  trace("-> wl_shm_pool@%u.create_buffer: wl_buffer=%u offset=%u\n",
+        state->wl_shm_pool, id, offset);
+
+  return id;
+}
+
+static void wayland_wl_shm_pool_resize(connection_t *conn, state_t *state) {
+  assert(state->wl_shm_pool > 0);
+
+  wayland_wl_shm_pool_resize_encode(
+      connection_reserve(conn, wayland_wl_shm_pool_resize_size),
+      state->wl_shm_pool, state->shm_pool_size);
+
+  trace("-> wl_shm_pool@%u.resize: size=%u\n", state->wl_shm_pool,
+        state->shm_pool_size);
+}
+
+static void wayland_wl_buffer_destroy(connection_t *conn, uint32_t wl_buffer) {
+  assert(wl_buffer > 0);
+
+  wayland_wl_buffer_destroy_encode(
+      connection_reserve(conn, wayland_wl_buffer_destroy_size), wl_buffer);
+
+  trace("-> wl_buffer@%u.destroy: \n", wl_buffer);
+}
+
+static void wayland_wl_surface_attach(connection_t *conn, state_t *state,
+                                      uint32_t wl_buffer) {
+  assert(state->wl_surface > 0);
+  assert(wl_buffer > 0);
+
+  wayland_wl_surface_attach_encode(
+      connection_reserve(conn, wayland_wl_surface_attach_size),
+      state->wl_surface, wl_buffer, 0, 0);
+
+  trace("-> wl_surface@%u.attach: wl_buffer=%u\n", state->wl_surface,
+        wl_buffer);
+}
+
+static uint32_t wayland_xdg_surface_get_toplevel(connection_t *conn,
+                                                 state_t *state) {
+  assert(state->xdg_surface > 0);
+
+  uint32_t id = connection_new_id(conn, &wayland_xdg_toplevel_interface);
+  wayland_xdg_surface_get_toplevel_encode(
+      connection_reserve(conn, wayland_xdg_surface_get_toplevel_size),
+      state->xdg_surface, id);
+
+  trace("-> xdg_surface@%u.get_toplevel: xdg_toplevel=%u\n", state->xdg_surface,
+        id);
+
+  return id;
+}
+
+static void wayland_wl_surface_commit(connection_t *conn, state_t *state) {
+  assert(state->wl_surface > 0);
+
+  wayland_wl_surface_commit_encode(
+      connection_reserve(conn, wayland_wl_surface_commit_size),
+      state->wl_surface);
+
+  trace("-> wl_surface@%u.commit: \n", state->wl_surface);
+}
+
+// Uses `damage_buffer` (buffer coordinates) when available, `damage` (surface
+// coordinates, the same thing for us since we do not scale nor transform)
+// otherwise.
+static void wayland_wl_surface_damage_buffer(connection_t *conn, state_t *state,
+                                             rect_t rect) {
+  assert(state->wl_surface > 0);
+
+  int damage_buffer =
+      state->wl_compositor_version >= wayland_wl_surface_damage_buffer_since;
+  if (damage_buffer)
+    wayland_wl_surface_damage_buffer_encode(
+        connection_reserve(conn, wayland_wl_surface_damage_buffer_size),
+        state->wl_surface, rect.x, rect.y, rect.w, rect.h);
+  else
+    wayland_wl_surface_damage_encode(
+        connection_reserve(conn, wayland_wl_surface_damage_size),
+        state->wl_surface, rect.x, rect.y, rect.w, rect.h);
+
+  const char *request = damage_buffer ? "damage_buffer" : "damage";
+  trace_str("-> wl_surface@%u.%s: x=%u y=%u w=%u h=%u\n", request,
+            strlen(request), state->wl_surface, rect.x, rect.y, rect.w,
+            rect.h);
+}
+
+static uint32_t wayland_wl_surface_frame(connection_t *conn, state_t *state) {
+  assert(state->wl_surface > 0);
+
+  uint32_t id = connection_new_id(conn, &wayland_wl_callback_interface);
+  wayland_wl_surface_frame_encode(
+      connection_reserve(conn, wayland_wl_surface_frame_size),
+      state->wl_surface, id);
+
+  trace("-> wl_surface@%u.frame: wl_callback=%u\n", state->wl_surface, id);
+
+  return id;
+}
+
+static void frame_stats_record_commit(frame_stats_t *stats) {
+  if (stats->done_ns == 0)
+    return;
+
+  uint64_t latency_us = (clock_now_ns() - stats->done_ns) / 1000;
+  stats->done_ns = 0;
+
+  uint32_t bucket = 0;
+  while (bucket + 1 < array_len(stats->latency_buckets) &&
+         (latency_us >> (bucket + 1)) != 0)
+    bucket++;
+
+  stats->latency_buckets[bucket]++;
+  stats->latency_us_sum += latency_us;
+  if (latency_us > stats->latency_us_max)
+    stats->latency_us_max = latency_us;
+  stats->frames++;
+}
+
+static void frame_stats_print(const frame_stats_t *stats) {
+  fprintf(stderr, "frames: %" PRIu64 "\n", stats->frames);
+  if (stats->frames == 0)
+    return;
+
+  fprintf(stderr,
+          "frame callback to commit: avg=%" PRIu64 "us max=%" PRIu64 "us\n",
+          stats->latency_us_sum / stats->frames, stats->latency_us_max);
+  for (uint32_t i = 0; i < array_len(stats->latency_buckets); i++) {
+    if (stats->latency_buckets[i] == 0)
+      continue;
+
+    fprintf(stderr, "  [%" PRIu64 "us, %" PRIu64 "us): %" PRIu64 "\n",
+            i == 0 ? 0 : (uint64_t)1 << i, (uint64_t)1 << (i + 1),
+            stats->latency_buckets[i]);
+  }
+}
+
+// A message not matching its signature: the compositor is broken, or we are
+// out of sync with it. Either way, there is no recovering.
+static void wayland_malformed(const char *message, uint32_t object_id) {
+  fprintf(stderr, "malformed %s for object %u\n", message, object_id);
+  exit(EPROTO);
+}
+
+static buffer_t *state_find_buffer(state_t *state, uint32_t wl_buffer) {
+  for (uint32_t i = 0; i < array_len(state->buffers); i++) {
+    if (state->buffers[i].wl_buffer == wl_buffer)
+      return &state->buffers[i];
+  }
+  return NULL;
+}
+
+static void wayland_wl_registry_handle_global(connection_t *conn,
+                                              state_t *state,
+                                              uint32_t object_id,
+                                              const uint32_t *body,
+                                              uint64_t body_len) {
+  wayland_wl_registry_global_event_t event = {0};
+  if (!wayland_wl_registry_global_decode(body, body_len, &event))
+    wayland_malformed("wl_registry.global", object_id);
+  const char *interface = event.interface;
+  uint32_t version = event.version;
+
+  trace_str("<- wl_registry@%u.global: name=%u interface=%s version=%u\n",
+            interface, event.interface_len - 1, object_id, event.name,
+            version);
+
+  if (strcmp(wayland_wl_shm_interface.name, interface) == 0) {
+    if (version > wayland_wl_shm_version_max)
+      version = wayland_wl_shm_version_max;
+    state->wl_shm = wayland_wl_registry_bind(
+        conn, object_id, event.name, &wayland_wl_shm_interface, version);
+  }
+
+  if (strcmp(wayland_xdg_wm_base_interface.name, interface) == 0) {
+    if (version > wayland_xdg_wm_base_version_max)
+      version = wayland_xdg_wm_base_version_max;
+    state->xdg_wm_base = wayland_wl_registry_bind(
+        conn, object_id, event.name, &wayland_xdg_wm_base_interface, version);
+  }
+
+  if (strcmp(wayland_wl_compositor_interface.name, interface) == 0) {
+    if (version > wayland_wl_compositor_version_max)
+      version = wayland_wl_compositor_version_max;
+    state->wl_compositor = wayland_wl_registry_bind(
+        conn, object_id, event.name, &wayland_wl_compositor_interface,
+        version);
+    state->wl_compositor_version = version;
+  }
+
+  // The first seat only.
+  if (strcmp(wayland_wl_seat_interface.name, interface) == 0 &&
+      state->wl_seat == 0) {
+    if (version > wayland_wl_seat_version_max)
+      version = wayland_wl_seat_version_max;
+    state->wl_seat = wayland_wl_registry_bind(
+        conn, object_id, event.name, &wayland_wl_seat_interface, version);
+    state->wl_seat_version = version;
+  }
+}
+
+static void wayland_wl_display_handle_error(connection_t *conn, state_t *state,
+                                            uint32_t object_id,
+                                            const uint32_t *body,
+                                            uint64_t body_len) {
+  (void)conn;
+  (void)state;
+
+  wayland_wl_display_error_event_t event = {0};
+  if (!wayland_wl_display_error_decode(body, body_len, &event))
+    wayland_malformed("wl_display.error", object_id);
+
+  fprintf(stderr, "fatal error: target_object_id=%u code=%u error=%s\n",
+          event.object_id, event.code, event.message);
+  exit(EINVAL);
+}
+
+static void wayland_wl_display_handle_delete_id(connection_t *conn,
+                                                state_t *state,
+                                                uint32_t object_id,
+                                                const uint32_t *body,
+                                                uint64_t body_len) {
+  (void)state;
+
+  wayland_wl_display_delete_id_event_t event = {0};
+  if (!wayland_wl_display_delete_id_decode(body, body_len, &event))
+    wayland_malformed("wl_display.delete_id", object_id);
+  trace("<- wl_display@%u.delete_id: id=%u\n", object_id, event.id);
+
+  connection_free_id(conn, event.id);
+}
+
+static void wayland_wl_shm_handle_format(connection_t *conn, state_t *state,
+                                         uint32_t object_id,
+                                         const uint32_t *body,
+                                         uint64_t body_len) {
+  (void)conn;
+  (void)state;
+
+  wayland_wl_shm_format_event_t event = {0};
+  if (!wayland_wl_shm_format_decode(body, body_len, &event))
+    wayland_malformed("wl_shm.format", object_id);
+  trace("<- wl_shm@%u.format: format=%#x\n", object_id, event.format);
+}
+
+static void wayland_wl_buffer_handle_release(connection_t *conn, state_t *state,
+                                             uint32_t object_id,
+                                             const uint32_t *body,
+                                             uint64_t body_len) {
+  (void)conn;
+  (void)body;
+
+  if (body_len != 0)
+    wayland_malformed("wl_buffer.release", object_id);
+
+  // Only buffers we attached are released, and those are never destroyed
+  // before their release.
+  buffer_t *buffer = state_find_buffer(state, object_id);
+  if (buffer == NULL) {
+    fprintf(stderr, "release of unknown wl_buffer %u\n", object_id);
+    exit(EPROTO);
+  }
+  buffer->busy = 0;
+
+  trace("<- wl_buffer@%u.release\n", object_id);
+}
+
+static void wayland_xdg_wm_base_handle_ping(connection_t *conn, state_t *state,
+                                            uint32_t object_id,
+                                            const uint32_t *body,
+                                            uint64_t body_len) {
+  wayland_xdg_wm_base_ping_event_t event = {0};
+  if (!wayland_xdg_wm_base_ping_decode(body, body_len, &event))
+    wayland_malformed("xdg_wm_base.ping", object_id);
+  trace("<- xdg_wm_base@%u.ping: ping=%u\n", object_id, event.serial);
+  wayland_xdg_wm_base_pong(conn, state, event.serial);
+  // Measured until the flush.
+  conn->pong_pending_ns = conn->read_ns;
+}
+
+static void wayland_xdg_toplevel_handle_configure(connection_t *conn,
+                                                  state_t *state,
+                                                  uint32_t object_id,
+                                                  const uint32_t *body,
+                                                  uint64_t body_len) {
+  (void)conn;
+
+  wayland_xdg_toplevel_configure_event_t event = {0};
+  if (!wayland_xdg_toplevel_configure_decode(body, body_len, &event))
+    wayland_malformed("xdg_toplevel.configure", object_id);
+  // Negative: as good as 0, the compositor lets us pick.
+  uint32_t w = event.width > 0 ? (uint32_t)event.width : 0;
+  uint32_t h = event.height > 0 ? (uint32_t)event.height : 0;
+
+  trace("<- xdg_toplevel@%u.configure: w=%u h=%u states[%u]\n", object_id, w,
+        h, event.states_len);
+
+  state->configure_w = w < surface_size_max ? w : surface_size_max;
+  state->configure_h = h < surface_size_max ? h : surface_size_max;
+}
+
+// Clean shutdown, on `xdg_toplevel.close` or on a signal.
+static void client_exit(connection_t *conn, state_t *state) {
+  frame_stats_print(&state->frame_stats);
+  metrics_print(stderr, &conn->metrics);
+  if (state->input.head > 0)
+    fprintf(stderr, "input: %" PRIu64 " events, %" PRIu64 " motions merged\n",
+            state->input.head + state->input.motions_merged,
+            state->input.motions_merged);
+  exit(0);
+}
+
+static void wayland_xdg_toplevel_handle_close(connection_t *conn,
+                                              state_t *state,
+                                              uint32_t object_id,
+                                              const uint32_t *body,
+                                              uint64_t body_len) {
+  (void)body;
+
+  if (body_len != 0)
+    wayland_malformed("xdg_toplevel.close", object_id);
+
+  trace("<- xdg_toplevel@%u.close\n", object_id);
+  client_exit(conn, state);
+}
+
+// Once per loop iteration, or when the ring is full.
+static void input_drain(state_t *state) {
+  input_ring_t *ring = &state->input;
+  for (; ring->tail != ring->head; ring->tail++) {
+    const input_event_t *event = &ring->events[ring->tail % input_ring_len];
+
+    switch (event->type) {
+    case INPUT_POINTER_ENTER:
+    case INPUT_POINTER_MOTION:
+      state->pointer_focus = 1;
+      state->pointer_x = event->x;
+      state->pointer_y = event->y;
+      break;
+    case INPUT_POINTER_LEAVE:
+      state->pointer_focus = 0;
+      break;
+    case INPUT_KEY:
+    case INPUT_POINTER_BUTTON:
+    case INPUT_POINTER_AXIS:
+    case INPUT_KEYBOARD_ENTER:
+    case INPUT_KEYBOARD_LEAVE:
+    case INPUT_MODIFIERS:
+      break;
+    }
+  }
+}
+
+static void input_push(state_t *state, input_event_t event) {
+  input_ring_t *ring = &state->input;
+  if (ring->head - ring->tail == input_ring_len)
+    input_drain(state);
+
+  ring->events[ring->head % input_ring_len] = event;
+  ring->head++;
+}
+
+// Only the latest position matters: a pending motion is moved, rather than
+// queuing another one.
+static void input_push_motion(state_t *state, input_event_t event) {
+  input_ring_t *ring = &state->input;
+  if (ring->head != ring->tail) {
+    input_event_t *last = &ring->events[(ring->head - 1) % input_ring_len];
+    if (last->type == INPUT_POINTER_MOTION) {
+      *last = event;
+      ring->motions_merged++;
+      return;
+    }
+  }
+
+  input_push(state, event);
+}
+
+static void wayland_wl_seat_handle_capabilities(connection_t *conn,
+                                                state_t *state,
+                                                uint32_t object_id,
+                                                const uint32_t *body,
+                                                uint64_t body_len) {
+  wayland_wl_seat_capabilities_event_t event = {0};
+  if (!wayland_wl_seat_capabilities_decode(body, body_len, &event))
+    wayland_malformed("wl_seat.capabilities", object_id);
+  uint32_t capabilities = event.capabilities;
+  trace("<- wl_seat@%u.capabilities: capabilities=%u\n", object_id,
+        capabilities);
+
+  // Before version 3, a device we no longer want lingers until we disconnect.
+  int can_release = state->wl_seat_version >= wayland_wl_seat_release_since;
+
+  int pointer = (capabilities & wayland_seat_capability_pointer) != 0;
+  if (pointer && state->wl_pointer == 0) {
+    state->wl_pointer = wayland_wl_seat_get_pointer(conn, state);
+  } else if (!pointer && state->wl_pointer != 0) {
+    if (can_release)
+      wayland_wl_pointer_release(conn, state);
+    state->wl_pointer = 0;
+    state->pointer_focus = 0;
+  }
+
+  int keyboard = (capabilities & wayland_seat_capability_keyboard) != 0;
+  if (keyboard && state->wl_keyboard == 0) {
+    state->wl_keyboard = wayland_wl_seat_get_keyboard(conn, state);
+  } else if (!keyboard && state->wl_keyboard != 0) {
+    if (can_release)
+      wayland_wl_keyboard_release(conn, state);
+    state->wl_keyboard = 0;
+  }
+}
+
+static void wayland_wl_seat_handle_name(connection_t *conn, state_t *state,
+                                        uint32_t object_id,
+                                        const uint32_t *body,
+                                        uint64_t body_len) {
+  (void)conn;
+  (void)state;
+
+  wayland_wl_seat_name_event_t event = {0};
+  if (!wayland_wl_seat_name_decode(body, body_len, &event))
+    wayland_malformed("wl_seat.name", object_id);
+  // The length includes the NULL terminator.
+  trace_str("<- wl_seat@%u.name: name=%s\n", event.name, event.name_len - 1,
+            object_id);
+}
+
+static void wayland_wl_pointer_handle_enter(connection_t *conn, state_t *state,
+                                            uint32_t object_id,
+                                            const uint32_t *body,
+                                            uint64_t body_len) {
+  (void)conn;
+
+  wayland_wl_pointer_enter_event_t event = {0};
+  if (!wayland_wl_pointer_enter_decode(body, body_len, &event))
+    wayland_malformed("wl_pointer.enter", object_id);
+  trace("<- wl_pointer@%u.enter: serial=%u surface=%u x=%d y=%d\n", object_id,
+        event.serial, event.surface, event.surface_x, event.surface_y);
+
+  input_push(state,
+             (input_event_t){.type = INPUT_POINTER_ENTER,
+                             .x = event.surface_x,
+                             .y = event.surface_y});
+}
+
+static void wayland_wl_pointer_handle_leave(connection_t *conn, state_t *state,
+                                            uint32_t object_id,
+                                            const uint32_t *body,
+                                            uint64_t body_len) {
+  (void)conn;
+
+  wayland_wl_pointer_leave_event_t event = {0};
+  if (!wayland_wl_pointer_leave_decode(body, body_len, &event))
+    wayland_malformed("wl_pointer.leave", object_id);
+  trace("<- wl_pointer@%u.leave: serial=%u surface=%u\n", object_id,
+        event.serial, event.surface);
+
+  input_push(state, (input_event_t){.type = INPUT_POINTER_LEAVE});
+}
+
+static void wayland_wl_pointer_handle_motion(connection_t *conn, state_t *state,
+                                             uint32_t object_id,
+                                             const uint32_t *body,
+                                             uint64_t body_len) {
+  (void)conn;
+
+  wayland_wl_pointer_motion_event_t event = {0};
+  if (!wayland_wl_pointer_motion_decode(body, body_len, &event))
+    wayland_malformed("wl_pointer.motion", object_id);
+  trace("<- wl_pointer@%u.motion: time=%u x=%d y=%d\n", object_id, event.time,
+        event.surface_x, event.surface_y);
+
+  input_push_motion(state,
+                    (input_event_t){.type = INPUT_POINTER_MOTION,
+                                    .time_ms = event.time,
+                                    .x = event.surface_x,
+                                    .y = event.surface_y});
+}
+
+static void wayland_wl_pointer_handle_button(connection_t *conn, state_t *state,
+                                             uint32_t object_id,
+                                             const uint32_t *body,
+                                             uint64_t body_len) {
+  (void)conn;
+
+  wayland_wl_pointer_button_event_t event = {0};
+  if (!wayland_wl_pointer_button_decode(body, body_len, &event))
+    wayland_malformed("wl_pointer.button", object_id);
+  trace("<- wl_pointer@%u.button: serial=%u time=%u button=%u state=%u\n",
+        object_id, event.serial, event.time, event.button, event.state);
+
+  input_push(state,
+             (input_event_t){.type = INPUT_POINTER_BUTTON,
+                             .time_ms = event.time,
+                             .code = event.button,
+                             .pressed = event.state});
+}
+
+static void wayland_wl_pointer_handle_axis(connection_t *conn, state_t *state,
+                                           uint32_t object_id,
+                                           const uint32_t *body,
+                                           uint64_t body_len) {
+  (void)conn;
+
+  wayland_wl_pointer_axis_event_t event = {0};
+  if (!wayland_wl_pointer_axis_decode(body, body_len, &event))
+    wayland_malformed("wl_pointer.axis", object_id);
+  trace("<- wl_pointer@%u.axis: time=%u axis=%u value=%d\n", object_id,
+        event.time, event.axis, event.value);
+
+  input_event_t input = {.type = INPUT_POINTER_AXIS, .time_ms = event.time};
+  if (event.axis == wayland_pointer_axis_horizontal)
+    input.x = event.value;
+  else
+    input.y = event.value;
+  input_push(state, input);
+}
+
+// The events before it form one logical event: we already apply them one by
+// one.
+static void wayland_wl_pointer_handle_frame(connection_t *conn, state_t *state,
+                                            uint32_t object_id,
+                                            const uint32_t *body,
+                                            uint64_t body_len) {
+  (void)conn;
+  (void)state;
+  (void)body;
+
+  if (body_len != 0)
+    wayland_malformed("wl_pointer.frame", object_id);
+
+  trace("<- wl_pointer@%u.frame\n", object_id);
+}
+
+static void wayland_wl_pointer_handle_axis_source(connection_t *conn,
+                                                  state_t *state,
+                                                  uint32_t object_id,
+                                                  const uint32_t *body,
+                                                  uint64_t body_len) {
+  (void)conn;
+  (void)state;
+
+  wayland_wl_pointer_axis_source_event_t event = {0};
+  if (!wayland_wl_pointer_axis_source_decode(body, body_len, &event))
+    wayland_malformed("wl_pointer.axis_source", object_id);
+  trace("<- wl_pointer@%u.axis_source: axis_source=%u\n", object_id,
+        event.axis_source);
+}
+
+static void wayland_wl_pointer_handle_axis_stop(connection_t *conn,
+                                                state_t *state,
+                                                uint32_t object_id,
+                                                const uint32_t *body,
+                                                uint64_t body_len) {
+  (void)conn;
+  (void)state;
+
+  wayland_wl_pointer_axis_stop_event_t event = {0};
+  if (!wayland_wl_pointer_axis_stop_decode(body, body_len, &event))
+    wayland_malformed("wl_pointer.axis_stop", object_id);
+  trace("<- wl_pointer@%u.axis_stop: time=%u axis=%u\n", object_id,
+        event.time, event.axis);
+}
+
+static void wayland_wl_pointer_handle_axis_discrete(connection_t *conn,
+                                                    state_t *state,
+                                                    uint32_t object_id,
+                                                    const uint32_t *body,
+                                                    uint64_t body_len) {
+  (void)conn;
+  (void)state;
+
+  wayland_wl_pointer_axis_discrete_event_t event = {0};
+  if (!wayland_wl_pointer_axis_discrete_decode(body, body_len, &event))
+    wayland_malformed("wl_pointer.axis_discrete", object_id);
+  trace("<- wl_pointer@%u.axis_discrete: axis=%u discrete=%d\n", object_id,
+        event.axis, event.discrete);
+}
+
+typedef struct keysym_name_t keysym_name_t;
+struct keysym_name_t {
+  const char *name;
+  uint32_t keysym;
+};
+
+// The names of a US layout, besides single characters, `F1` to `F35`, and
+// Unicode (`U20ac`) or hexadecimal (`0x1000`) ones.
+static const keysym_name_t keysym_names[] = {
+    {"space", 0x20},          {"exclam", 0x21},
+    {"quotedbl", 0x22},       {"numbersign", 0x23},
+    {"dollar", 0x24},         {"percent", 0x25},
+    {"ampersand", 0x26},      {"apostrophe", 0x27},
+    {"parenleft", 0x28},      {"parenright", 0x29},
+    {"asterisk", 0x2a},       {"plus", 0x2b},
+    {"comma", 0x2c},          {"minus", 0x2d},
+    {"period", 0x2e},         {"slash", 0x2f},
+    {"colon", 0x3a},          {"semicolon", 0x3b},
+    {"less", 0x3c},           {"equal", 0x3d},
+    {"greater", 0x3e},        {"question", 0x3f},
+    {"at", 0x40},             {"bracketleft", 0x5b},
+    {"backslash", 0x5c},      {"bracketright", 0x5d},
+    {"asciicircum", 0x5e},    {"underscore", 0x5f},
+    {"grave", 0x60},          {"braceleft", 0x7b},
+    {"bar", 0x7c},            {"braceright", 0x7d},
+    {"asciitilde", 0x7e},     {"BackSpace", 0xff08},
+    {"Tab", 0xff09},          {"Return", 0xff0d},
+    {"Escape", 0xff1b},       {"Delete", 0xffff},
+    {"Home", 0xff50},         {"Left", 0xff51},
+    {"Up", 0xff52},           {"Right", 0xff53},
+    {"Down", 0xff54},         {"Prior", 0xff55},
+    {"Next", 0xff56},         {"End", 0xff57},
+    {"Insert", 0xff63},       {"Menu", 0xff67},
+    {"ISO_Left_Tab", 0xfe20}, {"Shift_L", 0xffe1},
+    {"Shift_R", 0xffe2},      {"Control_L", 0xffe3},
+    {"Control_R", 0xffe4},    {"Caps_Lock", 0xffe5},
+    {"Meta_L", 0xffe7},       {"Meta_R", 0xffe8},
+    {"Alt_L", 0xffe9},        {"Alt_R", 0xffea},
+    {"Super_L", 0xffeb},      {"Super_R", 0xffec},
+};
+
+typedef struct keymap_key_name_t keymap_key_name_t;
+struct keymap_key_name_t {
+  char name[8];
+  uint32_t keycode;
+};
+
+static int keymap_is_space(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static int keymap_is_ident(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '_';
+}
+
+static const char *keymap_skip_space(const char *cur, const char *end) {
+  while (cur < end && keymap_is_space(*cur))
+    cur++;
+  return cur;
+}
+
+// Where `word` starts, as a whole word, or `end`.
+static const char *keymap_find_word(const char *cur, const char *end,
+                                    const char *word) {
+  const char *start = cur;
+  uint64_t word_len = strlen(word);
+  for (; (uint64_t)(end - cur) >= word_len; cur++) {
+    if (*cur != word[0] || memcmp(cur, word, word_len) != 0)
+      continue;
+    if ((cur > start && keymap_is_ident(cur[-1])) ||
+        (cur + word_len < end && keymap_is_ident(cur[word_len])))
+      continue;
+    return cur;
+  }
+  return end;
+}
+
+// The body of the section, between its braces.
+static void keymap_section(const char *text, const char *end,
+                           const char *section, const char **body,
+                           const char **body_end) {
+  *body = *body_end = end;
+
+  const char *cur = keymap_find_word(text, end, section);
+  while (cur < end && *cur != '{')
+    cur++;
+  if (cur == end)
+    return;
+
+  *body = ++cur;
+  for (uint32_t depth = 1; cur < end; cur++) {
+    if (*cur == '{') {
+      depth++;
+    } else if (*cur == '}' && --depth == 0) {
+      *body_end = cur;
+      return;
+    }
+  }
+  *body = end;
+}
+
+// Parse a `<NAME>` key name, at most 7 characters, NULL terminated in `name`.
+static const char *keymap_read_key_name(const char *cur, const char *end,
+                                        char name[8]) {
+  assert(*cur == '<');
+  const char *close = ++cur;
+  while (close < end && *close != '>')
+    close++;
+  if (close == end || close - cur > 7)
+    return NULL;
+
+  memset(name, 0, 8);
+  memcpy(name, cur, (uint64_t)(close - cur));
+  return close + 1;
+}
+
+static uint32_t keymap_parse_hex(const char *s, uint64_t len) {
+  uint32_t res = 0;
+  for (uint64_t i = 0; i < len; i++) {
+    char c = s[i];
+    uint32_t digit = c >= '0' && c <= '9'   ? (uint32_t)(c - '0')
+                     : c >= 'a' && c <= 'f' ? (uint32_t)(c - 'a' + 10)
+                     : c >= 'A' && c <= 'F' ? (uint32_t)(c - 'A' + 10)
+                                            : 16;
+    if (digit == 16 || i == 8)
+      return UINT32_MAX;
+    res = res * 16 + digit;
+  }
+  return res;
+}
+
+static uint32_t keysym_from_name(const char *name, uint64_t len) {
+  // A character of Latin-1: its keysym is its code point.
+  if (len == 1)
+    return (uint8_t)name[0];
+
+  if (name[0] == 'U') {
+    uint32_t code_point = keymap_parse_hex(name + 1, len - 1);
+    if (code_point != UINT32_MAX)
+      return code_point < 0x100 ? code_point : 0x01000000 | code_point;
+  }
+
+  if (len > 2 && name[0] == '0' && name[1] == 'x') {
+    uint32_t keysym = keymap_parse_hex(name + 2, len - 2);
+    return keysym == UINT32_MAX ? 0 : keysym;
+  }
+
+  if (name[0] == 'F' && len <= 3) {
+    uint32_t n = 0;
+    uint64_t i = 1;
+    for (; i < len && name[i] >= '0' && name[i] <= '9'; i++)
+      n = n * 10 + (uint32_t)(name[i] - '0');
+    if (i == len && n >= 1 && n <= 35)
+      return 0xffbe + n - 1;
+  }
+
+  for (uint32_t i = 0; i < array_len(keysym_names); i++) {
+    if (strlen(keysym_names[i].name) == len &&
+        memcmp(keysym_names[i].name, name, len) == 0)
+      return keysym_names[i].keysym;
+  }
+
+  return 0; // `NoSymbol`, or a name we do not know.
+}
+
+// Parse the `xkb_keycodes` and `xkb_symbols` sections of a keymap (as
+// `xkbcomp` writes it), once: names to keycodes, then keycodes to keysyms.
+// Everything else (types, compatibility, groups past the first) is ignored.
+static void keymap_parse(keymap_t *keymap, const char *text, uint64_t len) {
+  const char *end = text + len;
+  memset(keymap->keysyms, 0, sizeof(keymap->keysyms));
+
+  // `<AC01> = 38;` and `alias <LatA> = <AC01>;`.
+  keymap_key_name_t names[keymap_keycodes_len * 2];
+  uint32_t names_len = 0;
+
+  const char *cur = NULL, *section_end = NULL;
+  keymap_section(text, end, "xkb_keycodes", &cur, &section_end);
+  while (cur < section_end && names_len < array_len(names)) {
+    if (*cur != '<') {
+      cur++;
+      continue;
+    }
+
+    keymap_key_name_t *entry = &names[names_len];
+    cur = keymap_read_key_name(cur, section_end, entry->name);
+    if (cur == NULL)
+      break;
+    cur = keymap_skip_space(cur, section_end);
+    if (cur == section_end || *cur != '=')
+      continue;
+    cur = keymap_skip_space(cur + 1, section_end);
+
+    if (cur < section_end && *cur == '<') {
+      char target[8] = "";
+      cur = keymap_read_key_name(cur, section_end, target);
+      if (cur == NULL)
+        break;
+      for (uint32_t i = 0; i < names_len; i++) {
+        if (memcmp(names[i].name, target, sizeof(target)) == 0) {
+          entry->keycode = names[i].keycode;
+          names_len++;
+          break;
+        }
+      }
+      continue;
+    }
+
+    uint32_t keycode = 0;
+    for (; cur < section_end && *cur >= '0' && *cur <= '9'; cur++)
+      keycode = keycode * 10 + (uint32_t)(*cur - '0');
+    if (keycode < keymap_keycodes_len) {
+      entry->keycode = keycode;
+      names_len++;
+    }
+  }
+
+  // `key <AC01> { [ a, A ] };`, or with `symbols[Group1]= [ a, A ]` among
+  // other fields.
+  keymap_section(text, end, "xkb_symbols", &cur, &section_end);
+  while (cur < section_end) {
+    cur = keymap_find_word(cur, section_end, "key");
+    if (cur == section_end)
+      break;
+    cur = keymap_skip_space(cur + cstring_len("key"), section_end);
+    if (cur >= section_end || *cur != '<')
+      continue;
+
+    char name[8] = "";
+    cur = keymap_read_key_name(cur, section_end, name);
+    if (cur == NULL)
+      break;
+
+    const char *key_end = cur;
+    while (key_end < section_end && *key_end != '}')
+      key_end++;
+
+    uint32_t keycode = 0;
+    for (uint32_t i = 0; i < names_len && keycode == 0; i++) {
+      if (memcmp(names[i].name, name, sizeof(name)) == 0)
+        keycode = names[i].keycode;
+    }
+
+    // The first list of keysyms: `[Group1]` is an index, not a list.
+    const char *list = cur;
+    while (list < key_end) {
+      while (list < key_end && *list != '[')
+        list++;
+      if (list == key_end)
+        break;
+      list = keymap_skip_space(list + 1, key_end);
+      if ((uint64_t)(key_end - list) < cstring_len("Group") ||
+          memcmp(list, "Group", cstring_len("Group")) != 0)
+        break;
+    }
+
+    for (uint32_t level = 0; keycode != 0 && list < key_end && *list != ']';
+         level++) {
+      const char *sym = keymap_skip_space(list, key_end);
+      list = sym;
+      while (list < key_end && keymap_is_ident(*list))
+        list++;
+      if (level < keymap_levels && list > sym)
+        keymap->keysyms[keycode][level] =
+            keysym_from_name(sym, (uint64_t)(list - sym));
+
+      list = keymap_skip_space(list, key_end);
+      if (list < key_end && *list == ',')
+        list++;
+      else
+        break;
+    }
+    // One level: the same keysym with Shift.
+    if (keycode != 0 && keymap->keysyms[keycode][1] == 0)
+      keymap->keysyms[keycode][1] = keymap->keysyms[keycode][0];
+
+    cur = key_end;
+  }
+}
+
+static void wayland_wl_keyboard_handle_keymap(connection_t *conn,
+                                              state_t *state,
+                                              uint32_t object_id,
+                                              const uint32_t *body,
+                                              uint64_t body_len) {
+  (void)state;
+
+  wayland_wl_keyboard_keymap_event_t event = {0};
+  if (!wayland_wl_keyboard_keymap_decode(body, body_len, &event))
+    wayland_malformed("wl_keyboard.keymap", object_id);
+  trace("<- wl_keyboard@%u.keymap: format=%u size=%u\n", object_id,
+        event.format, event.size);
+
+  int fd = connection_pop_fd(conn);
+  if (event.format != wayland_keymap_format_xkb_v1) {
+    close(fd);
+    return;
+  }
+
+  // Past the end of the file, the parser would get `SIGBUS`.
+  struct stat st = {0};
+  if (fstat(fd, &st) == -1)
+    exit(errno);
+  if (event.size == 0 || (uint64_t)st.st_size < event.size) {
+    fprintf(stderr, "keymap of %u bytes in a file of %" PRIu64 " bytes\n",
+            event.size, (uint64_t)st.st_size);
+    exit(EPROTO);
+  }
+
+  // Read only and private (required from version 7): the compositor may
+  // share the same file with every client. Not read into a buffer: the pages
+  // are touched once, by the parser.
+  void *text = mmap(NULL, event.size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (text == MAP_FAILED)
+    exit(errno);
+  close(fd);
+
+  keymap_parse(&state->keymap, text, event.size);
+  munmap(text, event.size);
+}
+
+static void wayland_wl_keyboard_handle_enter(connection_t *conn, state_t *state,
+                                             uint32_t object_id,
+                                             const uint32_t *body,
+                                             uint64_t body_len) {
+  (void)conn;
+
+  wayland_wl_keyboard_enter_event_t event = {0};
+  if (!wayland_wl_keyboard_enter_decode(body, body_len, &event))
+    wayland_malformed("wl_keyboard.enter", object_id);
+  // The keys already pressed: they do not count as presses.
+  trace("<- wl_keyboard@%u.enter: serial=%u surface=%u keys[%u]\n", object_id,
+        event.serial, event.surface, event.keys_len);
+
+  input_push(state, (input_event_t){.type = INPUT_KEYBOARD_ENTER});
+}
+
+static void wayland_wl_keyboard_handle_leave(connection_t *conn, state_t *state,
+                                             uint32_t object_id,
+                                             const uint32_t *body,
+                                             uint64_t body_len) {
+  (void)conn;
+
+  wayland_wl_keyboard_leave_event_t event = {0};
+  if (!wayland_wl_keyboard_leave_decode(body, body_len, &event))
+    wayland_malformed("wl_keyboard.leave", object_id);
+  trace("<- wl_keyboard@%u.leave: serial=%u surface=%u\n", object_id,
+        event.serial, event.surface);
+
+  input_push(state, (input_event_t){.type = INPUT_KEYBOARD_LEAVE});
+}
+
+static void wayland_wl_keyboard_handle_key(connection_t *conn, state_t *state,
+                                           uint32_t object_id,
+                                           const uint32_t *body,
+                                           uint64_t body_len) {
+  (void)conn;
+
+  wayland_wl_keyboard_key_event_t event = {0};
+  if (!wayland_wl_keyboard_key_decode(body, body_len, &event))
+    wayland_malformed("wl_keyboard.key", object_id);
+  uint32_t keycode = event.key + keymap_evdev_offset;
+  uint32_t keysym =
+      keycode < keymap_keycodes_len
+          ? state->keymap.keysyms[keycode][state->keyboard_level]
+          : 0;
+  trace("<- wl_keyboard@%u.key: serial=%u time=%u key=%u state=%u "
+        "keysym=0x%x\n",
+        object_id, event.serial, event.time, event.key, event.state, keysym);
+
+  input_push(state,
+             (input_event_t){.type = INPUT_KEY,
+                             .time_ms = event.time,
+                             .code = event.key,
+                             .pressed = event.state,
+                             .keysym = keysym});
+}
+
+static void wayland_wl_keyboard_handle_modifiers(connection_t *conn,
+                                                 state_t *state,
+                                                 uint32_t object_id,
+                                                 const uint32_t *body,
+                                                 uint64_t body_len) {
+  (void)conn;
+
+  wayland_wl_keyboard_modifiers_event_t event = {0};
+  if (!wayland_wl_keyboard_modifiers_decode(body, body_len, &event))
+    wayland_malformed("wl_keyboard.modifiers", object_id);
+  uint32_t depressed = event.mods_depressed;
+  uint32_t latched = event.mods_latched;
+  trace("<- wl_keyboard@%u.modifiers: serial=%u depressed=%u latched=%u "
+        "locked=%u group=%u\n",
+        object_id, event.serial, depressed, latched, event.mods_locked,
+        event.group);
+
+  // Applies to the key events that follow, decoded before the ring is
+  // drained. Caps Lock is not taken into account.
+  state->keyboard_level = ((depressed | latched) & keymap_shift_mask) != 0;
+
+  input_push(state,
+             (input_event_t){.type = INPUT_MODIFIERS,
+                             .code = depressed | latched,
+                             .pressed = event.mods_locked});
+}
+
+// Key repeat is up to the client: we do not repeat anything.
+static void wayland_wl_keyboard_handle_repeat_info(connection_t *conn,
+                                                   state_t *state,
+                                                   uint32_t object_id,
+                                                   const uint32_t *body,
+                                                   uint64_t body_len) {
+  (void)conn;
+  (void)state;
+
+  wayland_wl_keyboard_repeat_info_event_t event = {0};
+  if (!wayland_wl_keyboard_repeat_info_decode(body, body_len, &event))
+    wayland_malformed("wl_keyboard.repeat_info", object_id);
+  trace("<- wl_keyboard@%u.repeat_info: rate=%d delay=%d\n", object_id,
+        event.rate, event.delay);
+}
+
+static void wayland_xdg_surface_handle_configure(connection_t *conn,
+                                                 state_t *state,
+                                                 uint32_t object_id,
+                                                 const uint32_t *body,
+                                                 uint64_t body_len) {
+  wayland_xdg_surface_configure_event_t event = {0};
+  if (!wayland_xdg_surface_configure_decode(body, body_len, &event))
+    wayland_malformed("xdg_surface.configure", object_id);
+  trace("<- xdg_surface@%u.configure: configure=%u\n", object_id,
+        event.serial);
+
+  // The next frame has the new size. 0x0: the compositor lets us pick, we keep
+  // the current one.
+  if (state->configure_w != 0 && state->configure_h != 0) {
+    state->w = state->configure_w;
+    state->h = state->configure_h;
+    state->stride = state->w * color_channels;
+  }
+
+  wayland_xdg_surface_ack_configure(conn, state, event.serial);
+  state->state = STATE_SURFACE_ACKED_CONFIGURE;
+}
+
+static void wayland_wl_callback_handle_done(connection_t *conn, state_t *state,
+                                            uint32_t object_id,
+                                            const uint32_t *body,
+                                            uint64_t body_len) {
+  (void)conn;
+
+  wayland_wl_callback_done_event_t event = {0};
+  if (!wayland_wl_callback_done_decode(body, body_len, &event))
+    wayland_malformed("wl_callback.done", object_id);
+  trace("<- wl_callback@%u.done: time=%u\n", object_id, event.callback_data);
+
+  if (object_id == state->wl_callback_registry_done) {
+    state->wl_callback_registry_done = 0;
+    // Nothing else is coming: better to fail than to wait forever.
+    if (state->wl_compositor == 0 || state->wl_shm == 0 ||
+        state->xdg_wm_base == 0) {
+      fprintf(stderr, "the compositor lacks wl_compositor, wl_shm or "
+                      "xdg_wm_base\n");
+      exit(EPROTO);
+    }
+    return;
+  }
+
+  if (object_id != state->wl_callback) {
+    fprintf(stderr, "wl_callback.done for %u, expected the frame callback %u\n",
+            object_id, state->wl_callback);
+    exit(EPROTO);
+  }
+  state->wl_callback = 0;
+  state->frame_stats.done_ns = clock_now_ns();
+}
+
+static const wayland_event_handler_t wayland_wl_display_events[] = {
+    wayland_wl_display_handle_error,     // 0: error
+    wayland_wl_display_handle_delete_id, // 1: delete_id
+};
+static const wayland_interface_t wayland_wl_display_interface = {
+    .name = "wl_display",
+    .index = INTERFACE_WL_DISPLAY,
+    .events = wayland_wl_display_events,
+    .events_len = array_len(wayland_wl_display_events),
+    .event_fds = wayland_wl_display_event_fds,
+};
+
+static const wayland_event_handler_t wayland_wl_registry_events[] = {
+    wayland_wl_registry_handle_global, // 0: global
+    NULL,                              // 1: global_remove
+};
+static const wayland_interface_t wayland_wl_registry_interface = {
+    .name = "wl_registry",
+    .index = INTERFACE_WL_REGISTRY,
+    .events = wayland_wl_registry_events,
+    .events_len = array_len(wayland_wl_registry_events),
+    .event_fds = wayland_wl_registry_event_fds,
+};
+
+static const wayland_interface_t wayland_wl_compositor_interface = {
+    .name = "wl_compositor",
+    .index = INTERFACE_WL_COMPOSITOR,
+};
+
+static const wayland_event_handler_t wayland_wl_surface_events[] = {
+    NULL, // 0: enter
+    NULL, // 1: leave
+    NULL, // 2: preferred_buffer_scale
+    NULL, // 3: preferred_buffer_transform
+};
+static const wayland_interface_t wayland_wl_surface_interface = {
+    .name = "wl_surface",
+    .index = INTERFACE_WL_SURFACE,
+    .events = wayland_wl_surface_events,
+    .events_len = array_len(wayland_wl_surface_events),
+    .event_fds = wayland_wl_surface_event_fds,
+};
+
+static const wayland_event_handler_t wayland_wl_callback_events[] = {
+    wayland_wl_callback_handle_done, // 0: done
+};
+static const wayland_interface_t wayland_wl_callback_interface = {
+    .name = "wl_callback",
+    .index = INTERFACE_WL_CALLBACK,
+    .events = wayland_wl_callback_events,
+    .events_len = array_len(wayland_wl_callback_events),
+    .event_fds = wayland_wl_callback_event_fds,
+};
+
+static const wayland_event_handler_t wayland_wl_shm_events[] = {
+    wayland_wl_shm_handle_format, // 0: format
+};
+static const wayland_interface_t wayland_wl_shm_interface = {
+    .name = "wl_shm",
+    .index = INTERFACE_WL_SHM,
+    .events = wayland_wl_shm_events,
+    .events_len = array_len(wayland_wl_shm_events),
+    .event_fds = wayland_wl_shm_event_fds,
+};
+
+static const wayland_interface_t wayland_wl_shm_pool_interface = {
+    .name = "wl_shm_pool",
+    .index = INTERFACE_WL_SHM_POOL,
+};
+
+static const wayland_event_handler_t wayland_wl_buffer_events[] = {
+    wayland_wl_buffer_handle_release, // 0: release
+};
+static const wayland_interface_t wayland_wl_buffer_interface = {
+    .name = "wl_buffer",
+    .index = INTERFACE_WL_BUFFER,
+    .events = wayland_wl_buffer_events,
+    .events_len = array_len(wayland_wl_buffer_events),
+    .event_fds = wayland_wl_buffer_event_fds,
+};
+
+static const wayland_event_handler_t wayland_xdg_wm_base_events[] = {
+    wayland_xdg_wm_base_handle_ping, // 0: ping
+};
+static const wayland_interface_t wayland_xdg_wm_base_interface = {
+    .name = "xdg_wm_base",
+    .index = INTERFACE_XDG_WM_BASE,
+    .events = wayland_xdg_wm_base_events,
+    .events_len = array_len(wayland_xdg_wm_base_events),
+    .event_fds = wayland_xdg_wm_base_event_fds,
+};
+
+static const wayland_event_handler_t wayland_xdg_surface_events[] = {
+    wayland_xdg_surface_handle_configure, // 0: configure
+};
+static const wayland_interface_t wayland_xdg_surface_interface = {
+    .name = "xdg_surface",
+    .index = INTERFACE_XDG_SURFACE,
+    .events = wayland_xdg_surface_events,
+    .events_len = array_len(wayland_xdg_surface_events),
+    .event_fds = wayland_xdg_surface_event_fds,
+};
+
+static const wayland_event_handler_t wayland_xdg_toplevel_events[] = {
+    wayland_xdg_toplevel_handle_configure, // 0: configure
+    wayland_xdg_toplevel_handle_close,     // 1: close
+    NULL,                                  // 2: configure_bounds
+    NULL,                                  // 3: wm_capabilities
+};
+static const wayland_interface_t wayland_xdg_toplevel_interface = {
+    .name = "xdg_toplevel",
+    .index = INTERFACE_XDG_TOPLEVEL,
+    .events = wayland_xdg_toplevel_events,
+    .events_len = array_len(wayland_xdg_toplevel_events),
+    .event_fds = wayland_xdg_toplevel_event_fds,
+};
+
+static const wayland_event_handler_t wayland_wl_seat_events[] = {
+    wayland_wl_seat_handle_capabilities, // 0: capabilities
+    wayland_wl_seat_handle_name,         // 1: name
+};
+static const wayland_interface_t wayland_wl_seat_interface = {
+    .name = "wl_seat",
+    .index = INTERFACE_WL_SEAT,
+    .events = wayland_wl_seat_events,
+    .events_len = array_len(wayland_wl_seat_events),
+    .event_fds = wayland_wl_seat_event_fds,
+};
+
+static const wayland_event_handler_t wayland_wl_pointer_events[] = {
+    wayland_wl_pointer_handle_enter,         // 0: enter
+    wayland_wl_pointer_handle_leave,         // 1: leave
+    wayland_wl_pointer_handle_motion,        // 2: motion
+    wayland_wl_pointer_handle_button,        // 3: button
+    wayland_wl_pointer_handle_axis,          // 4: axis
+    wayland_wl_pointer_handle_frame,         // 5: frame
+    wayland_wl_pointer_handle_axis_source,   // 6: axis_source
+    wayland_wl_pointer_handle_axis_stop,     // 7: axis_stop
+    wayland_wl_pointer_handle_axis_discrete, // 8: axis_discrete
+};
+static const wayland_interface_t wayland_wl_pointer_interface = {
+    .name = "wl_pointer",
+    .index = INTERFACE_WL_POINTER,
+    .events = wayland_wl_pointer_events,
+    .events_len = array_len(wayland_wl_pointer_events),
+    .event_fds = wayland_wl_pointer_event_fds,
+};
+
+static const wayland_event_handler_t wayland_wl_keyboard_events[] = {
+    wayland_wl_keyboard_handle_keymap,      // 0: keymap
+    wayland_wl_keyboard_handle_enter,       // 1: enter
+    wayland_wl_keyboard_handle_leave,       // 2: leave
+    wayland_wl_keyboard_handle_key,         // 3: key
+    wayland_wl_keyboard_handle_modifiers,   // 4: modifiers
+    wayland_wl_keyboard_handle_repeat_info, // 5: repeat_info
+};
+static const wayland_interface_t wayland_wl_keyboard_interface = {
+    .name = "wl_keyboard",
+    .index = INTERFACE_WL_KEYBOARD,
+    .events = wayland_wl_keyboard_events,
+    .events_len = array_len(wayland_wl_keyboard_events),
+    .event_fds = wayland_wl_keyboard_event_fds,
+};
+
+// One indexed load to find the object's interface, one for the handler.
+static void wayland_handle_message(connection_t *conn, state_t *state,
+                                   const uint32_t *msg, uint64_t msg_len) {
+  assert(msg_len >= wayland_header_size);
+
+  uint32_t object_id = msg[0];
+  // The size is in the upper half, already checked by `connection_dispatch`:
+  // `msg` is exactly one message.
+  uint16_t opcode = (uint16_t)(msg[1] & 0xffff);
+  const uint32_t *body = msg + 2;
+  uint64_t body_len = msg_len - wayland_header_size;
+
+  // Objects stay known until `wl_display.delete_id`: events racing their
+  // destruction still land here.
+  const wayland_interface_t *interface =
+      object_id < conn->objects_cap ? conn->objects[object_id] : NULL;
+  if (interface == NULL) {
+    fprintf(stderr, "event for unknown object %u (opcode=%u)\n", object_id,
+            opcode);
+    exit(EPROTO);
+  }
+  if (opcode >= interface->events_len) {
+    fprintf(stderr, "unknown event %u for %s@%u\n", opcode, interface->name,
+            object_id);
+    exit(EPROTO);
+  }
+
+  metrics_count(conn->metrics.events[interface->index], opcode, msg_len);
+  conn->metrics.events_total++;
+
+  if (interface->events[opcode] == NULL) {
+    trace_str("<- %s@%u: event %u skipped\n", interface->name,
+              (uint32_t)strlen(interface->name), object_id, opcode);
+    // Its file descriptors are ours: leaving them queued would hand them to
+    // the next event with one.
+    for (uint32_t i = interface->event_fds(opcode); i > 0; i--)
+      close(connection_pop_fd(conn));
+    return;
+  }
+  interface->events[opcode](conn, state, object_id, body, body_len);
+}
+
+#ifndef WAYLAND_LOGO_XRGB
+typedef void (*rgb_to_xrgb_fn)(uint32_t *dst, const uint8_t *src,
+                               uint64_t pixel_count);
+
+static void rgb_to_xrgb_scalar(uint32_t *dst, const uint8_t *src,
+                               uint64_t pixel_count) {
+  for (uint64_t i = 0; i < pixel_count; i++) {
+    uint8_t r = src[i * 3 + 0];
+    uint8_t g = src[i * 3 + 1];
+    uint8_t b = src[i * 3 + 2];
+    dst[i] = (r << 16) | (g << 8) | b;
+  }
+}
+
+#ifdef WAYLAND_X86_SIMD
+// Shuffle mask turning 4 packed RGB pixels (12 bytes) into 4 XRGB pixels in
+// memory order B, G, R, X. A mask byte of -1 (high bit set) yields 0.
+#define RGB_TO_XRGB_SHUFFLE(o)                                                 \
+  (o) + 2, (o) + 1, (o) + 0, -1, (o) + 5, (o) + 4, (o) + 3, -1, (o) + 8,       \
+      (o) + 7, (o) + 6, -1, (o) + 11, (o) + 10, (o) + 9, -1
+
+// 16 pixels (48 bytes) per iteration. The last load starts at byte 32 instead
+// of 36 so that we never read past the end of the source.
+__attribute__((target("ssse3"))) static void
+rgb_to_xrgb_ssse3(uint32_t *dst, const uint8_t *src, uint64_t pixel_count) {
+  const __m128i mask = _mm_setr_epi8(RGB_TO_XRGB_SHUFFLE(0));
+  const __m128i mask_last = _mm_setr_epi8(RGB_TO_XRGB_SHUFFLE(4));
+
+  uint64_t i = 0;
+  for (; i + 16 <= pixel_count; i += 16) {
+    const uint8_t *s = src + i * 3;
+    __m128i *d = (__m128i *)(dst + i);
+
+    __m128i a = _mm_loadu_si128((const __m128i *)(s + 0));
+    __m128i b = _mm_loadu_si128((const __m128i *)(s + 12));
+    __m128i c = _mm_loadu_si128((const __m128i *)(s + 24));
+    __m128i e = _mm_loadu_si128((const __m128i *)(s + 32));
+
+    _mm_storeu_si128(d + 0, _mm_shuffle_epi8(a, mask));
+    _mm_storeu_si128(d + 1, _mm_shuffle_epi8(b, mask));
+    _mm_storeu_si128(d + 2, _mm_shuffle_epi8(c, mask));
+    _mm_storeu_si128(d + 3, _mm_shuffle_epi8(e, mask_last));
+  }
+
+  rgb_to_xrgb_scalar(dst + i, src + i * 3, pixel_count - i);
+}
+
+// Same layout as the SSSE3 version, with two 128 bits loads per 256 bits
+// register since `vpshufb` does not cross lanes.
+__attribute__((target("avx2"))) static void
+rgb_to_xrgb_avx2(uint32_t *dst, const uint8_t *src, uint64_t pixel_count) {
+  const __m256i mask = _mm256_setr_epi8(RGB_TO_XRGB_SHUFFLE(0),
+                                        RGB_TO_XRGB_SHUFFLE(0));
+  const __m256i mask_last = _mm256_setr_epi8(RGB_TO_XRGB_SHUFFLE(0),
+                                             RGB_TO_XRGB_SHUFFLE(4));
+
+  uint64_t i = 0;
+  for (; i + 16 <= pixel_count; i += 16) {
+    const uint8_t *s = src + i * 3;
+    __m256i *d = (__m256i *)(dst + i);
+
+    __m256i a = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(s + 0))),
+        _mm_loadu_si128((const __m128i *)(s + 12)), 1);
+    __m256i b = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(s + 24))),
+        _mm_loadu_si128((const __m128i *)(s + 32)), 1);
+
+    _mm256_storeu_si256(d + 0, _mm256_shuffle_epi8(a, mask));
+    _mm256_storeu_si256(d + 1, _mm256_shuffle_epi8(b, mask_last));
+  }
+
+  rgb_to_xrgb_scalar(dst + i, src + i * 3, pixel_count - i);
+}
+#endif
+
+static rgb_to_xrgb_fn rgb_to_xrgb_select() {
+#ifdef WAYLAND_X86_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    return rgb_to_xrgb_avx2;
+  if (__builtin_cpu_supports("ssse3"))
+    return rgb_to_xrgb_ssse3;
+#endif
+  return rgb_to_xrgb_scalar;
+}
+
+static rgb_to_xrgb_fn rgb_to_xrgb = rgb_to_xrgb_scalar;
+#endif
+
+#ifdef WAYLAND_LOGO_RLE
+// Decode the run-length encoded logo (see `wayland-logo-gen.c`) straight into
+// the destination, in one pass. Literal packets go through the SIMD
+// conversion.
+static void rle_decode_xrgb(uint32_t *dst, uint64_t dst_pixel_count,
+                            const uint8_t *src, uint64_t src_len) {
+  uint64_t i = 0;
+  uint64_t j = 0;
+  while (j < src_len) {
+    uint8_t n = src[j++];
+    uint64_t count = (n & 0x7f) + 1;
+    assert(i + count <= dst_pixel_count);
+
+    if (n & 0x80) {
+      assert(j + 3 <= src_len);
+      uint32_t pixel = (src[j + 0] << 16) | (src[j + 1] << 8) | src[j + 2];
+      j += 3;
+
+      for (uint64_t k = 0; k < count; k++)
+        dst[i + k] = pixel;
+    } else {
+      assert(j + count * 3 <= src_len);
+      rgb_to_xrgb(dst + i, src + j, count);
+      j += count * 3;
+    }
+    i += count;
+  }
+  assert(i == dst_pixel_count);
+}
+#endif
+
+// Fill `logo_w * logo_h` pixels with the logo, from whichever source this
+// build (or the environment) provides.
+static void render_logo_native(uint32_t *pixels, const state_t *state) {
+  uint64_t pixel_count = (uint64_t)logo_w * logo_h;
+
+  if (state->logo_xrgb != NULL) {
+    assert(pixel_count * sizeof(uint32_t) == state->logo_xrgb_size);
+    memcpy(pixels, state->logo_xrgb, state->logo_xrgb_size);
+    return;
+  }
+
+#if defined(WAYLAND_LOGO_XRGB)
+  // Already in the `wl_shm` format: plain copy.
+  assert(pixel_count * sizeof(uint32_t) <= wayland_logo_xrgb_len);
+  memcpy(pixels, wayland_logo_xrgb, pixel_count * sizeof(uint32_t));
+#elif defined(WAYLAND_LOGO_RLE)
+  rle_decode_xrgb(pixels, pixel_count, wayland_logo_rle, wayland_logo_rle_len);
+#else
+  assert(pixel_count * 3 <= wayland_logo_len);
+  rgb_to_xrgb(pixels, wayland_logo, pixel_count);
+#endif
+}
+
+typedef struct mip_t mip_t;
+struct mip_t {
+  const uint32_t *pixels;
+  uint32_t w;
+  uint32_t h;
+};
+
+// Mip chain of the logo, each level being half the size of the previous one.
+// Built on first use. The whole chain is at most 4/3 of the first level.
+static uint32_t logo_mips_data[117 * 150 * 2];
+static mip_t logo_mips[16];
+static uint32_t logo_mips_len = 0;
+
+// 2x2 box filter, averaging each channel of 4 source pixels.
+static void downscale_box_2x(uint32_t *dst, const mip_t *src) {
+  uint32_t w = src->w / 2;
+  uint32_t h = src->h / 2;
+
+  for (uint32_t y = 0; y < h; y++) {
+    const uint32_t *row0 = src->pixels + (y * 2 + 0) * src->w;
+    const uint32_t *row1 = src->pixels + (y * 2 + 1) * src->w;
+
+    for (uint32_t x = 0; x < w; x++) {
+      uint32_t a = row0[x * 2], b = row0[x * 2 + 1];
+      uint32_t c = row1[x * 2], d = row1[x * 2 + 1];
+
+      // Red and blue together, then green, with room for the carries.
+      uint32_t rb = ((a & 0xff00ff) + (b & 0xff00ff) + (c & 0xff00ff) +
+                     (d & 0xff00ff) + 0x020002) >>
+                    2;
+      uint32_t g = ((a & 0xff00) + (b & 0xff00) + (c & 0xff00) +
+                    (d & 0xff00) + 0x0200) >>
+                   2;
+      dst[y * w + x] = (rb & 0xff00ff) | (g & 0xff00);
+    }
+  }
+}
+
+static void logo_mips_build(const state_t *state) {
+  uint32_t *data = logo_mips_data;
+  render_logo_native(data, state);
+  logo_mips[0] = (mip_t){.pixels = data, .w = logo_w, .h = logo_h};
+  logo_mips_len = 1;
+
+  // Stop before a level gets too small for bilinear sampling.
+  while (logo_mips_len < array_len(logo_mips)) {
+    const mip_t *prev = &logo_mips[logo_mips_len - 1];
+    if (prev->w / 2 < 2 || prev->h / 2 < 2)
+      break;
+
+    data += prev->w * prev->h;
+    assert(data + (prev->w / 2) * (prev->h / 2) <=
+           logo_mips_data + array_len(logo_mips_data));
+    downscale_box_2x(data, prev);
+
+    logo_mips[logo_mips_len++] =
+        (mip_t){.pixels = data, .w = prev->w / 2, .h = prev->h / 2};
+  }
+}
+
+// Smallest level still at least as big as the destination, so that bilinear
+// sampling never skips source pixels. The first level when upscaling.
+static const mip_t *logo_mips_pick(uint32_t w, uint32_t h) {
+  const mip_t *mip = &logo_mips[0];
+  for (uint32_t i = 1; i < logo_mips_len; i++) {
+    if (logo_mips[i].w < w || logo_mips[i].h < h)
+      break;
+    mip = &logo_mips[i];
+  }
+  return mip;
+}
+
+// Source coordinate of a destination pixel center, in 24.8 fixed point,
+// clamped so that the next source pixel (`+1`) always exists.
+static void scale_coord(uint32_t d, uint32_t dst_len, uint32_t src_len,
+                        uint32_t *s0, uint32_t *frac) {
+  int64_t s = (((int64_t)d * 2 + 1) * src_len * 256) / ((int64_t)dst_len * 2) -
+              128;
+  if (s < 0)
+    s = 0;
+  if (s > (int64_t)(src_len - 1) * 256)
+    s = (int64_t)(src_len - 1) * 256;
+
+  *s0 = (uint32_t)(s >> 8);
+  *frac = (uint32_t)(s & 0xff);
+  if (*s0 == src_len - 1) {
+    *s0 = src_len - 2;
+    *frac = 256;
+  }
+}
+
+// Horizontal sampling of a destination column: the left source pixel, and the
+// weight of the right one, in 8.8 fixed point.
+typedef struct scale_column_t scale_column_t;
+struct scale_column_t {
+  uint32_t x0;
+  uint32_t fx;
+};
+
+// One per destination column, up to `surface_size_max`. Only depends on the
+// widths: built once per frame, and shared by every row and thread.
+static scale_column_t scale_columns[8192];
+
+static void scale_columns_build(uint32_t dst_w, uint32_t src_w) {
+  assert(dst_w <= array_len(scale_columns));
+  for (uint32_t x = 0; x < dst_w; x++)
+    scale_coord(x, dst_w, src_w, &scale_columns[x].x0, &scale_columns[x].fx);
+}
+
+// Same arithmetic as `scale_pixels_2`, so that both paths produce the same
+// pixels: each channel (the padding byte too) is blended vertically, truncated
+// to 8 bits, then horizontally.
+static uint32_t scale_pixel(const uint32_t *row0, const uint32_t *row1,
+                            scale_column_t column, uint32_t fy) {
+  uint32_t x0 = column.x0, fx = column.fx;
+  uint32_t pixel = 0;
+  for (uint32_t shift = 0; shift < 32; shift += 8) {
+    uint32_t left = (((row0[x0] >> shift) & 0xff) * (256 - fy) +
+                     ((row1[x0] >> shift) & 0xff) * fy) >>
+                    8;
+    uint32_t right = (((row0[x0 + 1] >> shift) & 0xff) * (256 - fy) +
+                      ((row1[x0 + 1] >> shift) & 0xff) * fy) >>
+                     8;
+    pixel |= ((left * (256 - fx) + right * fx) >> 8) << shift;
+  }
+  return pixel;
+}
+
+// One destination row, one pixel at a time.
+static void scale_row_scalar(uint32_t *out, const uint32_t *row0,
+                             const uint32_t *row1,
+                             const scale_column_t *columns, uint32_t dst_w,
+                             uint32_t fy) {
+  for (uint32_t x = 0; x < dst_w; x++)
+    out[x] = scale_pixel(row0, row1, columns[x], fy);
+}
+
+#if defined(WAYLAND_X86_SIMD) && defined(__SSE2__)
+// Horizontal weights of a column, for its left and right source pixels:
+// `256 - fx` in the 4 low lanes, `fx` in the 4 high ones.
+static inline __m128i scale_weights(scale_column_t column) {
+  __m128i w = _mm_cvtsi32_si128((int)(column.fx << 16 | (256 - column.fx)));
+  w = _mm_unpacklo_epi16(w, w);
+  return _mm_unpacklo_epi32(w, w);
+}
+
+// Two destination pixels, 16 bits per channel. Both neighbours of a column
+// share a register, and products stay below 255 * 256 so unsigned 16 bits
+// arithmetic does not overflow.
+static inline __m128i scale_pixels_2(const uint32_t *row0,
+                                     const uint32_t *row1,
+                                     const scale_column_t *columns,
+                                     __m128i wy0, __m128i wy1) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i top = _mm_unpacklo_epi64(
+      _mm_loadl_epi64((const __m128i *)(row0 + columns[0].x0)),
+      _mm_loadl_epi64((const __m128i *)(row0 + columns[1].x0)));
+  __m128i bottom = _mm_unpacklo_epi64(
+      _mm_loadl_epi64((const __m128i *)(row1 + columns[0].x0)),
+      _mm_loadl_epi64((const __m128i *)(row1 + columns[1].x0)));
+
+  __m128i v0 = _mm_srli_epi16(
+      _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(top, zero), wy0),
+                    _mm_mullo_epi16(_mm_unpacklo_epi8(bottom, zero), wy1)),
+      8);
+  __m128i v1 = _mm_srli_epi16(
+      _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(top, zero), wy0),
+                    _mm_mullo_epi16(_mm_unpackhi_epi8(bottom, zero), wy1)),
+      8);
+
+  __m128i h0 = _mm_mullo_epi16(v0, scale_weights(columns[0]));
+  __m128i h1 = _mm_mullo_epi16(v1, scale_weights(columns[1]));
+  return _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(h0, h1),
+                                      _mm_unpackhi_epi64(h0, h1)),
+                        8);
+}
+#endif
+
+// Bilinear scaling of the destination rows `[y_begin, y_end)`, in one pass,
+// with `columns` built by `scale_columns_build`.
+static void scale_bilinear(uint32_t *dst, uint32_t dst_w, uint32_t dst_h,
+                           uint32_t dst_stride, const mip_t *src,
+                           const scale_column_t *columns, uint32_t y_begin,
+                           uint32_t y_end) {
+  assert(src->w >= 2);
+  assert(src->h >= 2);
+  assert(y_end <= dst_h);
+
+  for (uint32_t y = y_begin; y < y_end; y++) {
+    uint32_t y0 = 0, fy = 0;
+    scale_coord(y, dst_h, src->h, &y0, &fy);
+    const uint32_t *row0 = src->pixels + y0 * src->w;
+    const uint32_t *row1 = row0 + src->w;
+    uint32_t *out = (uint32_t *)((uint8_t *)dst + y * dst_stride);
+
+    uint32_t x = 0;
+#if defined(WAYLAND_X86_SIMD) && defined(__SSE2__)
+    // 4 pixels per iteration, stored at once.
+    const __m128i wy0 = _mm_set1_epi16((int16_t)(256 - fy));
+    const __m128i wy1 = _mm_set1_epi16((int16_t)fy);
+    for (; x + 4 <= dst_w; x += 4) {
+      __m128i a = scale_pixels_2(row0, row1, columns + x, wy0, wy1);
+      __m128i b = scale_pixels_2(row0, row1, columns + x + 2, wy0, wy1);
+      _mm_storeu_si128((__m128i *)(out + x), _mm_packus_epi16(a, b));
+    }
+#endif
+    scale_row_scalar(out + x, row0, row1, columns + x, dst_w - x, fy);
+  }
+}
+
+// Below this many pixels, waking the workers up costs more than it saves.
+static const uint64_t render_parallel_min_pixels = 512 * 512;
+// Rows per tile, before rounding for alignment: big enough to amortize
+// fetching a tile, small enough to balance the load between threads.
+static const uint32_t render_tile_rows = 32;
+
+// Buffers in the pool start on one.
+static const uint32_t cache_line_size = 64;
+
+// One frame to scale, split into horizontal tiles handed out to the threads
+// in order. A tile is a whole number of rows starting on a cache line (as the
+// buffer does), so that no two threads ever write to the same cache line.
+typedef struct render_job_t render_job_t;
+struct render_job_t {
+  uint32_t *pixels;
+  uint32_t w;
+  uint32_t h;
+  uint32_t stride;
+  const mip_t *mip;
+  const scale_column_t *columns;
+  uint32_t tile_rows;
+  uint32_t tiles_len;
+  // Next tile to take, shared by all threads.
+  uint32_t tile_next;
+};
+
+// Fixed pool of workers, started on the first large frame. The main thread
+// takes part in the rendering, and waits on the barrier for all the tiles to
+// be done before the buffer is attached and committed.
+typedef struct render_pool_t render_pool_t;
+struct render_pool_t {
+  pthread_t workers[63];
+  uint32_t workers_len;
+  uint8_t started;
+  pthread_barrier_t start;
+  pthread_barrier_t done;
+  render_job_t job;
+};
+
+static render_pool_t render_pool = {0};
+
+static void render_job_run(render_job_t *job) {
+  while (1) {
+    uint32_t tile = __atomic_fetch_add(&job->tile_next, 1, __ATOMIC_RELAXED);
+    if (tile >= job->tiles_len)
+      return;
+
+    uint32_t y_begin = tile * job->tile_rows;
+    uint32_t y_end =
+        y_begin + job->tile_rows < job->h ? y_begin + job->tile_rows : job->h;
+    scale_bilinear(job->pixels, job->w, job->h, job->stride, job->mip,
+                   job->columns, y_begin, y_end);
+  }
+}
+
+static void *render_worker(void *arg) {
+  render_pool_t *pool = arg;
+  while (1) {
+    pthread_barrier_wait(&pool->start);
+    render_job_run(&pool->job);
+    pthread_barrier_wait(&pool->done);
+  }
+  return NULL;
+}
+
+// One per CPU, the main thread included.
+static uint32_t render_workers_default() {
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  return cpus > 1 ? (uint32_t)cpus - 1 : 0;
+}
+
+static void render_pool_start(render_pool_t *pool, uint32_t workers_len) {
+  if (workers_len > array_len(pool->workers))
+    workers_len = array_len(pool->workers);
+
+  if (pthread_barrier_init(&pool->start, NULL, workers_len + 1) != 0 ||
+      pthread_barrier_init(&pool->done, NULL, workers_len + 1) != 0)
+    exit(EAGAIN);
+
+  // The workers only ever render: signals (see `signal_create_fd`) stay
+  // blocked in them, since they inherit the mask of the main thread.
+  for (uint32_t i = 0; i < workers_len; i++) {
+    if (pthread_create(&pool->workers[i], NULL, render_worker, pool) != 0)
+      exit(EAGAIN);
+  }
+  pool->workers_len = workers_len;
+  pool->started = 1;
+}
+
+// Scale in parallel, returning once every tile is written.
+static void render_pool_scale(render_pool_t *pool, uint32_t *pixels,
+                              const state_t *state, const mip_t *mip) {
+  // Rows are 4 bytes aligned: round tiles up to a multiple of the rows needed
+  // to span a whole number of cache lines.
+  assert((uintptr_t)pixels % cache_line_size == 0);
+  uint32_t align_rows = 1;
+  while ((uint64_t)align_rows * state->stride % cache_line_size != 0)
+    align_rows *= 2;
+  uint32_t tile_rows =
+      (render_tile_rows + align_rows - 1) / align_rows * align_rows;
+
+  pool->job = (render_job_t){
+      .pixels = pixels,
+      .w = state->w,
+      .h = state->h,
+      .stride = state->stride,
+      .mip = mip,
+      .columns = scale_columns,
+      .tile_rows = tile_rows,
+      .tiles_len = (state->h + tile_rows - 1) / tile_rows,
+  };
+
+  // The barriers also order the writes of the job and of the pixels between
+  // the threads.
+  pthread_barrier_wait(&pool->start);
+  render_job_run(&pool->job);
+  pthread_barrier_wait(&pool->done);
+}
+
+// Fill the `state->w * state->h` surface with the logo, scaled from the
+// nearest mip level if the surface is not the logo size.
+static void render_logo(uint32_t *pixels, const state_t *state) {
+  if (state->w == logo_w && state->h == logo_h &&
+      state->stride == logo_w * color_channels) {
+    render_logo_native(pixels, state);
+    return;
+  }
+
+  if (logo_mips_len == 0)
+    logo_mips_build(state);
+
+  const mip_t *mip = logo_mips_pick(state->w, state->h);
+  scale_columns_build(state->w, mip->w);
+  if ((uint64_t)state->w * state->h < render_parallel_min_pixels) {
+    scale_bilinear(pixels, state->w, state->h, state->stride, mip,
+                   scale_columns, 0, state->h);
+    return;
+  }
+
+  if (!render_pool.started)
+    render_pool_start(&render_pool, render_workers_default());
+  render_pool_scale(&render_pool, pixels, state, mip);
+}
+
+static int rect_contains(rect_t outer, rect_t inner) {
+  return inner.x >= outer.x && inner.y >= outer.y &&
+         inner.x + inner.w <= outer.x + outer.w &&
+         inner.y + inner.h <= outer.y + outer.h;
+}
+
+static rect_t rect_union(rect_t a, rect_t b) {
+  uint32_t x0 = a.x < b.x ? a.x : b.x;
+  uint32_t y0 = a.y < b.y ? a.y : b.y;
+  uint32_t x1 = a.x + a.w > b.x + b.w ? a.x + a.w : b.x + b.w;
+  uint32_t y1 = a.y + a.h > b.y + b.h ? a.y + a.h : b.y + b.h;
+  return (rect_t){.x = x0, .y = y0, .w = x1 - x0, .h = y1 - y0};
+}
+
+// Record a changed region. Rectangles already covered are dropped, and
+// adjacent or overlapping rectangles spanning the same columns (or rows) are
+// merged. Past the capacity, everything collapses into the bounding box: one
+// big damage request is cheaper for both sides than many small ones.
+static void damage_add(damage_t *damage, rect_t rect) {
+  if (rect.w == 0 || rect.h == 0)
+    return;
+
+  for (uint32_t i = 0; i < damage->len; i++) {
+    rect_t *r = &damage->rects[i];
+    if (rect_contains(*r, rect))
+      return;
+
+    if (r->x == rect.x && r->w == rect.w &&
+        (r->y + r->h == rect.y || rect.y + rect.h == r->y)) {
+      *r = rect_union(*r, rect);
+      return;
+    }
+
+    if (r->y == rect.y && r->h == rect.h && rect.x <= r->x + r->w &&
+        r->x <= rect.x + rect.w) {
+      *r = rect_union(*r, rect);
+      return;
+    }
+  }
+
+  if (damage->len == array_len(damage->rects)) {
+    rect_t bounds = rect;
+    for (uint32_t i = 0; i < damage->len; i++)
+      bounds = rect_union(bounds, damage->rects[i]);
+
+    damage->rects[0] = bounds;
+    damage->len = 1;
+    return;
+  }
+
+  damage->rects[damage->len++] = rect;
+}
+
+static int buffer_holds_frame(const buffer_t *buffer, const state_t *state) {
+  return buffer->content_w == state->w && buffer->content_h == state->h &&
+         buffer->content_tick == state->ticks;
+}
+
+// The bar sweeps the width of the surface once per second.
+static rect_t animation_bar_rect(const state_t *state, uint64_t tick) {
+  if (state->animation_hz == 0 || state->h < animation_bar_h * 2)
+    return (rect_t){0};
+
+  uint32_t bar_w = state->w / 8 > 0 ? state->w / 8 : 1;
+  uint32_t step = tick % state->animation_hz;
+  return (rect_t){
+      .x = (uint32_t)((uint64_t)step * (state->w - bar_w) /
+                      state->animation_hz),
+      .y = state->h - animation_bar_h,
+      .w = bar_w,
+      .h = animation_bar_h,
+  };
+}
+
+// Redraw the bottom rows: only them change from one tick to the next.
+static void render_animation(uint32_t *pixels, const state_t *state) {
+  rect_t bar = animation_bar_rect(state, state->ticks);
+  if (bar.w == 0)
+    return;
+
+  for (uint32_t y = bar.y; y < bar.y + bar.h; y++) {
+    uint32_t *row = pixels + (uint64_t)y * (state->stride / sizeof(uint32_t));
+    for (uint32_t x = 0; x < state->w; x++)
+      row[x] = x >= bar.x && x < bar.x + bar.w ? animation_bar_fg
+                                               : animation_bar_bg;
+  }
+}
+
+// The lowest offset where `size` bytes overlap no buffer's region, possibly
+// past the end of the pool. Regions belong to buffers (a `capacity` of 0 for
+// none), so those given up are found again without any bookkeeping. Offsets
+// are multiples of `cache_line_size`: with the pool mapped on a page, buffers
+// start on a cache line.
+static uint64_t shm_pool_find(const state_t *state, uint32_t size) {
+  uint64_t offset = 0;
+  // Each pass moves past the regions overlapping the candidate: there is no
+  // room before their end.
+  for (int moved = 1; moved;) {
+    moved = 0;
+    for (uint32_t i = 0; i < array_len(state->buffers); i++) {
+      const buffer_t *other = &state->buffers[i];
+      uint64_t other_end = (uint64_t)other->offset + other->capacity;
+      if (other->capacity != 0 && offset < other_end &&
+          other->offset < offset + size) {
+        offset = (other_end + cache_line_size - 1) / cache_line_size *
+                 cache_line_size;
+        moved = 1;
+      }
+    }
+  }
+  return offset;
+}
+
+// Carve a region in the first gap that fits, the regions given up by buffers
+// which outgrew them included, or at the end of the pool, growing it if
+// needed. The caller's buffer must not hold a region yet (`capacity` of 0).
+static uint32_t shm_pool_alloc(connection_t *conn, state_t *state,
+                               uint32_t size) {
+  uint64_t offset = shm_pool_find(state, size);
+  uint64_t end = offset + size;
+  if (end > state->shm_pool_size) {
+    shm_pool_grow(end + end / 2, state);
+    if (state->wl_shm_pool != 0)
+      wayland_wl_shm_pool_resize(conn, state);
+  }
+
+  return (uint32_t)offset;
+}
+
+// Make the buffer's `wl_buffer` match the surface size. A `wl_buffer` has a
+// fixed size, so it is replaced, but its region of the pool is kept if the
+// new frame fits in it.
+static void buffer_fit(connection_t *conn, state_t *state, buffer_t *buffer) {
+  assert(!buffer->busy);
+
+  if (buffer->wl_buffer != 0)
+    wayland_wl_buffer_destroy(conn, buffer->wl_buffer);
+
+  uint32_t size = state->h * state->stride;
+  if (size > buffer->capacity) {
+    // Given up: with its `wl_buffer` gone, nothing uses it anymore.
+    buffer->capacity = 0;
+
+    // The pool grows anyway: room for the window to grow some more, before
+    // the next move.
+    uint32_t capacity = size;
+    if (shm_pool_find(state, size) + size > state->shm_pool_size)
+      capacity += size / 2;
+    buffer->offset = shm_pool_alloc(conn, state, capacity);
+    buffer->capacity = capacity;
+  }
+
+  buffer->wl_buffer =
+      wayland_wl_shm_pool_create_buffer(conn, state, buffer->offset);
+  buffer->content_w = state->w;
+  buffer->content_h = state->h;
+}
+
+// Pick the buffer for the next frame, render into it if needed, and record
+// what changed compared to the frame on screen. The content only depends on
+// the surface size, so nothing is rewritten when a buffer already holds a
+// frame of that size. Returns NULL when the compositor still holds all the
+// buffers.
+static buffer_t *render_frame(connection_t *conn, state_t *state,
+                              damage_t *damage) {
+  if (state->front != NULL && buffer_holds_frame(state->front, state))
+    return state->front;
+
+  buffer_t *buffer = NULL;
+  for (uint32_t i = 0; i < array_len(state->buffers); i++) {
+    buffer_t *candidate = &state->buffers[i];
+    if (candidate->busy)
+      continue;
+
+    if (buffer == NULL || buffer_holds_frame(candidate, state))
+      buffer = candidate;
+  }
+  if (buffer == NULL)
+    return NULL;
+
+  // The buffer already has the logo at this size (e.g. pre-rendered): at most
+  // the animation moved.
+  if (buffer->content_w == state->w && buffer->content_h == state->h) {
+    // Same size on screen: only the bar changed. Before rendering: `buffer`
+    // may be the front buffer.
+    if (state->front != NULL && state->front->content_w == state->w &&
+        state->front->content_h == state->h) {
+      damage_add(damage,
+                 animation_bar_rect(state, state->front->content_tick));
+      damage_add(damage, animation_bar_rect(state, state->ticks));
+    } else {
+      damage_add(damage, (rect_t){.w = state->w, .h = state->h});
+    }
+
+    render_animation((uint32_t *)(state->shm_pool_data + buffer->offset),
+                     state);
+    buffer->content_tick = state->ticks;
+    return buffer;
+  }
+
+  if (buffer->content_w != state->w || buffer->content_h != state->h)
+    buffer_fit(conn, state, buffer);
+
+  // After `buffer_fit`, which may have moved the pool.
+  uint32_t *pixels = (uint32_t *)(state->shm_pool_data + buffer->offset);
+  render_logo(pixels, state);
+  render_animation(pixels, state);
+  buffer->content_tick = state->ticks;
+
+  damage_add(damage, (rect_t){.w = state->w, .h = state->h});
+  return buffer;
+}
+
+// Handle every complete message received so far, each through a view into
+// the receive buffer.
+static void connection_dispatch(connection_t *conn, state_t *state) {
+  uint64_t offset = 0;
+  while (conn->in_len - offset >= wayland_header_size) {
+    // In the upper half of the second word.
+    uint16_t announced_size = ((const uint32_t *)(conn->in + offset))[1] >> 16;
+    // We could not tell where the next message starts (or, for 0, would
+    // never move past this one).
+    if (announced_size < wayland_header_size ||
+        roundup_4(announced_size) != announced_size) {
+      fprintf(stderr, "invalid message size %u\n", announced_size);
+      exit(EPROTO);
+    }
+
+    if (conn->in_len - offset < announced_size) // Incomplete.
+      break;
+
+    wayland_handle_message(conn, state,
+                           (const uint32_t *)(conn->in + offset),
+                           announced_size);
+    offset += announced_size;
+  }
+
+  memmove(conn->in, conn->in + offset, conn->in_len - offset);
+  conn->in_len -= offset;
+}
+
+typedef enum event_source_t event_source_t;
+enum event_source_t {
+  EVENT_SOURCE_WAYLAND,
+  EVENT_SOURCE_TIMER,
+  EVENT_SOURCE_SIGNAL,
+  EVENT_SOURCE_WAKEUP,
+};
+
+static void event_loop_add(int epoll_fd, int fd, event_source_t source) {
+  struct epoll_event event = {.events = EPOLLIN, .data.u32 = source};
+  if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) == -1)
+    exit(errno);
+}
+
+// Animation ticks at a fixed rate. Ticks elapsed while we were busy are
+// coalesced by the kernel into one read.
+static int timer_create_periodic(uint32_t hz) {
+  int fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+  if (fd == -1)
+    exit(errno);
+
+  struct timespec period = {.tv_nsec = 1000 * 1000 * 1000 / hz};
+  if (hz == 1)
+    period = (struct timespec){.tv_sec = 1};
+  struct itimerspec spec = {.it_interval = period, .it_value = period};
+  if (timerfd_settime(fd, 0, &spec, NULL) == -1)
+    exit(errno);
+
+  return fd;
+}
+
+// Turn SIGINT and SIGTERM (shut down cleanly) and SIGUSR1 (dump the metrics)
+// into readable events, handled from the loop instead of from a signal
+// handler.
+static int signal_create_fd() {
+  sigset_t mask;
+  sigemptyset(&mask);
+  sigaddset(&mask, SIGINT);
+  sigaddset(&mask, SIGTERM);
+  sigaddset(&mask, SIGUSR1);
+  if (sigprocmask(SIG_BLOCK, &mask, NULL) == -1)
+    exit(errno);
+
+  int fd = signalfd(-1, &mask, SFD_CLOEXEC | SFD_NONBLOCK);
+  if (fd == -1)
+    exit(errno);
+
+  return fd;
+}
+
+static void *prerender_run(void *arg) {
+  prerender_t *prerender = arg;
+  render_logo_native(prerender->pixels, prerender->state);
+
+  uint64_t one = 1;
+  if (write(prerender->state->wakeup_fd, &one, sizeof(one)) == -1)
+    exit(errno);
+  return NULL;
+}
+
+// Most compositors let us pick the size: carve the first buffer now and fill
+// it while we wait for the globals and the configure.
+static void prerender_start(connection_t *conn, state_t *state) {
+  assert(state->w == logo_w && state->h == logo_h);
+
+  // The first region of the pool: nothing is carved yet.
+  buffer_t *buffer = &state->buffers[0];
+  assert(buffer->capacity == 0);
+  buffer->offset = shm_pool_alloc(conn, state, state->h * state->stride);
+  buffer->capacity = state->h * state->stride;
+  assert(buffer->offset == 0);
+  buffer->content_w = state->w;
+  buffer->content_h = state->h;
+  // Without the animation bar, drawn when the frame is committed.
+  buffer->content_tick = UINT64_MAX;
+
+  state->prerender.pixels =
+      (uint32_t *)(state->shm_pool_data + buffer->offset);
+  state->prerender.state = state;
+  if (pthread_create(&state->prerender.thread, NULL, prerender_run,
+                     &state->prerender) != 0) {
+    // Not worth failing for.
+    prerender_run(&state->prerender);
+    return;
+  }
+  state->prerender.running = 1;
+}
+
+static void prerender_join(state_t *state) {
+  if (!state->prerender.running)
+    return;
+
+  if (pthread_join(state->prerender.thread, NULL) != 0)
+    exit(EINVAL);
+  state->prerender.running = 0;
+}
+
+// Needs a new frame: the acked configure is not applied yet, or the animation
+// moved since the frame on screen.
+static int state_needs_frame(const state_t *state) {
+  if (state->state == STATE_SURFACE_ACKED_CONFIGURE)
+    return 1;
+
+  return state->state == STATE_SURFACE_ATTACHED && state->front != NULL &&
+         !buffer_holds_frame(state->front, state);
+}
+
+int main() {
+#if !defined(NDEBUG)
+  atexit(trace_dump);
+#endif
+
+  struct timeval tv = {0};
+  if (gettimeofday(&tv, NULL) == -1)
+    exit(errno);
+  srand(tv.tv_sec * 1000 * 1000 + tv.tv_usec);
+
+#ifndef WAYLAND_LOGO_XRGB
+  rgb_to_xrgb = rgb_to_xrgb_select();
+#endif
+
+  int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd == -1)
+    exit(errno);
+
+  connection_t conn = {
+      .fd = wayland_display_connect(),
+      .ids_max = wayland_display_object_id,
+  };
+  connection_set_object(&conn, wayland_display_object_id,
+                        &wayland_wl_display_interface);
+
+  state_t state = {
+      .wl_registry = wayland_wl_display_get_registry(&conn),
+      .w = logo_w,
+      .h = logo_h,
+      .stride = logo_w * color_channels,
+  };
+
+  // The globals end with the callback. Sent right away: the first round trip
+  // overlaps with the rest of the setup.
+  state.wl_callback_registry_done = wayland_wl_display_sync(&conn);
+  connection_flush(&conn);
+
+  char *logo_xrgb_path = getenv("WAYLAND_LOGO_XRGB_PATH");
+  if (logo_xrgb_path != NULL)
+    logo_xrgb_map(logo_xrgb_path, &state);
+
+  char *animation_hz = getenv("WAYLAND_ANIMATION_HZ");
+  if (animation_hz != NULL)
+    state.animation_hz = (uint32_t)strtoul(animation_hz, NULL, 10);
+
+  event_loop_add(epoll_fd, conn.fd, EVENT_SOURCE_WAYLAND);
+  int signal_fd = signal_create_fd();
+  event_loop_add(epoll_fd, signal_fd, EVENT_SOURCE_SIGNAL);
+
+  int timer_fd = -1;
+  if (state.animation_hz > 0) {
+    timer_fd = timer_create_periodic(state.animation_hz);
+    event_loop_add(epoll_fd, timer_fd, EVENT_SOURCE_TIMER);
+  }
+
+  // For other threads to wake the loop up.
+  state.wakeup_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (state.wakeup_fd == -1)
+    exit(errno);
+  event_loop_add(epoll_fd, state.wakeup_fd, EVENT_SOURCE_WAKEUP);
+
+  // Enough for the logo size: the pool grows if the compositor asks for more.
+  create_shared_memory_file(state.h * state.stride * array_len(state.buffers),
+                            &state);
+  prerender_start(&conn, &state);
+
+  while (1) {
+    // Everything queued during the previous iteration goes out in one go.
+    connection_flush(&conn);
+
+    // Sleep until something happens: no busy polling, and a ping is answered
+    // as soon as it arrives, even between two animation ticks.
+    struct epoll_event events[4];
+    int events_len = epoll_wait(epoll_fd, events, array_len(events), -1);
+    if (events_len == -1 && errno != EINTR)
+      exit(errno);
+
+    for (int i = 0; i < events_len; i++) {
+      uint64_t count = 0;
+      struct signalfd_siginfo siginfo = {0};
+
+      switch ((event_source_t)events[i].data.u32) {
+      case EVENT_SOURCE_WAYLAND:
+        connection_read(&conn);
+        connection_dispatch(&conn, &state);
+        // The pong leaves now, not with the frame: rendering (and the other
+        // events of this wakeup) must not delay it.
+        if (conn.pong_pending_ns != 0)
+          connection_flush(&conn);
+        input_drain(&state);
+        break;
+      case EVENT_SOURCE_TIMER:
+        if (read(timer_fd, &count, sizeof(count)) == sizeof(count))
+          state.ticks += count;
+        break;
+      case EVENT_SOURCE_SIGNAL:
+        if (read(signal_fd, &siginfo, sizeof(siginfo)) != sizeof(siginfo))
+          break;
+
+        if (siginfo.ssi_signo == SIGUSR1) {
+          metrics_print(stderr, &conn.metrics);
+        } else {
+          fprintf(stderr, "signal %u\n", siginfo.ssi_signo);
+          client_exit(&conn, &state);
+        }
+        break;
+      case EVENT_SOURCE_WAKEUP:
+        if (read(state.wakeup_fd, &count, sizeof(count)) == -1)
+          exit(errno);
+        // The pre-render is done: the thread is about to return.
+        prerender_join(&state);
+        break;
+      }
+    }
+
+    if (state.wl_compositor != 0 && state.wl_shm != 0 &&
+        state.xdg_wm_base != 0 &&
+        state.wl_surface == 0) { // Bind phase complete, need to create surface.
+      assert(state.state == STATE_NONE);
+
+      state.wl_surface = wayland_wl_compositor_create_surface(&conn, &state);
+      state.xdg_surface = wayland_xdg_wm_base_get_xdg_surface(&conn, &state);
+      state.xdg_toplevel = wayland_xdg_surface_get_toplevel(&conn, &state);
+      // Speculatively, in the same write: the pool, and the pre-rendered
+      // buffer, used as is if the configure keeps our size.
+      state.wl_shm_pool = wayland_wl_shm_create_pool(&conn, &state);
+      state.buffers[0].wl_buffer = wayland_wl_shm_pool_create_buffer(
+          &conn, &state, state.buffers[0].offset);
+      wayland_wl_surface_commit(&conn, &state);
+    }
+
+    // Render only once the compositor is done with the previous frame.
+    if (state_needs_frame(&state) && state.wl_callback == 0) {
+      // Render a frame.
+      assert(state.wl_surface != 0);
+      assert(state.xdg_surface != 0);
+      assert(state.xdg_toplevel != 0);
+
+      assert(state.wl_shm_pool != 0);
+      assert(state.shm_pool_data != 0);
+      assert(state.shm_pool_size != 0);
+
+      // Before touching the buffers, or moving the pool. Rather than
+      // blocking here (and leaving pings unanswered), rendered on the wakeup.
+      if (state.prerender.running)
+        continue;
+
+      damage_t damage = {0};
+      buffer_t *buffer = render_frame(&conn, &state, &damage);
+      if (buffer == NULL) // Wait for the compositor to release a buffer.
+        continue;
+
+      // Nothing changed: the commit alone applies the acked configure, and the
+      // compositor keeps using the buffer it already has.
+      if (damage.len > 0) {
+        wayland_wl_surface_attach(&conn, &state, buffer->wl_buffer);
+        for (uint32_t i = 0; i < damage.len; i++)
+          wayland_wl_surface_damage_buffer(&conn, &state, damage.rects[i]);
+
+        buffer->busy = 1;
+        state.front = buffer;
+        state.wl_callback = wayland_wl_surface_frame(&conn, &state);
+      }
+      wayland_wl_surface_commit(&conn, &state);
+      frame_stats_record_commit(&state.frame_stats);
+
+      state.state = STATE_SURFACE_ATTACHED;
+    }
+  }
+}